@@ -31,8 +31,8 @@ fail () {
     exit 1
 }
 
-[ "$#" -eq 1 ] || fail "One toolchain argument required, $# provided"
+[ "$#" -ge 1 ] || fail "One toolchain argument required, $# provided"
 [ -f $ROOT_DIR/cmake/toolchains/$1 ] || fail "$ROOT_DIR/cmake/toolchains/$1 not found."
 
-cmake -G Ninja -H$ROOT_DIR -B$ROOT_DIR/_build -DCMAKE_TOOLCHAIN_FILE=$ROOT_DIR/cmake/toolchains/$1
+cmake -G Ninja -H$ROOT_DIR -B$ROOT_DIR/_build -DCMAKE_TOOLCHAIN_FILE=$ROOT_DIR/cmake/toolchains/$1 "${@:2}"
 cmake --build $ROOT_DIR/_build
@@ -28,6 +28,24 @@
 set(TUNIS_BACKEND "GL" CACHE STRING "backend implementation to use")
 set_property(CACHE TUNIS_BACKEND PROPERTY STRINGS GL NanoVG-GL3)
 
+##
+# Stream vertex and index data through a ring of fenced buffer segments instead
+# of re-specifying the whole buffer objects with glBufferData every frame.
+##
+option(TUNIS_STREAMING_UPLOAD "Stream geometry through a fenced buffer ring" ON)
+
+##
+# Use 32-bit indices so batches never need to be split every 65536 vertices.
+# Requires GL_OES_element_index_uint on OpenGL ES 2.0.
+##
+option(TUNIS_INDEX_32BIT "Use 32-bit vertex indices" OFF)
+
+##
+# Make RefCountedSOA thread-safe, so Paints, Path2Ds and Images can be created
+# and released from any thread, at the cost of atomic reference counting.
+##
+option(TUNIS_THREAD_SAFE_SOA "Use the thread-safe RefCountedSOA storage" OFF)
+
 ##
 # Enable/Disable Samples
 ##
@@ -26,14 +26,19 @@
 
 #include <TunisContextState.h>
 #include <TunisColor.h>
+#include <TunisFrameStats.h>
 #include <TunisImage.h>
+#include <TunisJobSystem.h>
 #include <TunisPaint.h>
 #include <TunisPath2D.h>
 #include <TunisMath.h>
 #include <TunisGradient.h>
 #include <TunisPattern.h>
+#include <TunisTextMetrics.h>
 
+#include <functional>
 #include <memory>
+#include <string>
 
 namespace tunis
 {
@@ -58,6 +63,53 @@ public:
 
     void endFrame();
 
+    /*!
+     * \brief frameStats returns the counters collected while the last frame
+     * was flushed by endFrame().
+     */
+    const FrameStats &frameStats() const;
+
+    /*!
+     * \brief setExecutor makes the context run its tessellation and image
+     * decoding tasks on executor, which must outlive the context. By default,
+     * and when executor is nullptr, the tasks run on a built-in JobSystem of
+     * TUNIS_THREAD_COUNT threads shared by every context.
+     */
+    void setExecutor(Executor *executor);
+
+    /*!
+     * \brief setTessellationCacheBudget sets how much memory the meshes of the
+     * paths drawn in the previous frames may retain, instead of
+     * TUNIS_TESSELLATION_CACHE_BUDGET. With 0, every draw is tessellated again
+     * every frame.
+     */
+    void setTessellationCacheBudget(size_t bytes);
+
+    /*!
+     * \brief setTessellationObserver makes endFrame() call observer(true)
+     * right before it tessellates the draws missing from the cache, and
+     * observer(false) right after, e.g. to account the heap allocations of
+     * that stage alone. nullptr removes the observer.
+     */
+    void setTessellationObserver(std::function<void(bool tessellating)> observer);
+
+    /*!
+     * \brief loadFonts makes the context draw text with the font repository
+     * (.tfp) at path, instead of TUNIS_FONT_PATH. The file is mapped in
+     * memory, and shared by every context loading it.
+     *
+     * \return false if it is missing or invalid, the current fonts are kept.
+     */
+    bool loadFonts(const std::string &path);
+
+    /*!
+     * \brief setFillMode selects how the following fills are rasterized. See
+     * FillMode. FillMode::stencilThenCover requires a stencil buffer.
+     */
+    void setFillMode(FillMode mode);
+
+    FillMode fillMode() const;
+
     /*!
      * \brief save saves the entire state of the canvas by pushing the current
      * state onto a stack.
@@ -71,6 +123,60 @@ public:
      */
     void restore();
 
+    /*!
+     * \brief scale adds a scaling transformation to the canvas units
+     * horizontally and/or vertically.
+     *
+     * \param x Scaling factor in the horizontal direction. A negative value
+     * flips pixels across the vertical axis.
+     * \param y Scaling factor in the vertical direction. A negative value flips
+     * pixels across the horizontal axis.
+     */
+    void scale(float x, float y);
+
+    /*!
+     * \brief rotate adds a rotation to the transformation matrix.
+     *
+     * \param angle The rotation angle, clockwise in radians.
+     */
+    void rotate(float angle);
+
+    /*!
+     * \brief translate adds a translation transformation to the current
+     * matrix by moving the canvas and its origin x units horizontally and y
+     * units vertically.
+     */
+    void translate(float x, float y);
+
+    /*!
+     * \brief transform multiplies the current transformation with the matrix
+     * described by the arguments of this method:
+     *
+     *     a c e
+     *     b d f
+     *     0 0 1
+     *
+     * \param a Horizontal scaling.
+     * \param b Horizontal skewing.
+     * \param c Vertical skewing.
+     * \param d Vertical scaling.
+     * \param e Horizontal moving.
+     * \param f Vertical moving.
+     */
+    void transform(float a, float b, float c, float d, float e, float f);
+
+    /*!
+     * \brief setTransform resets the current transform to the identity matrix,
+     * and then invokes the transform() method with the same arguments.
+     */
+    void setTransform(float a, float b, float c, float d, float e, float f);
+
+    /*!
+     * \brief resetTransform resets the current transform to the identity
+     * matrix.
+     */
+    void resetTransform();
+
     /*!
      * \brief fillRect draws a filled rectangle whose starting point is at the
      * coordinates (x, y) with the specified width and height and whose style is
@@ -119,9 +225,9 @@ public:
      * To draw the outlines of the characters in a string, call the context's
      * strokeText() method.
      *
-     * \param text the text string to render into the context. The text is
-     * rendered using the settings specified by font, textAlign, textBaseline,
-     * and direction.
+     * \param text the text string to render into the context, in UTF-8. The
+     * text is rendered using the settings specified by font, textAlign,
+     * textBaseline, and direction.
      * \param x The x -coordinate of the point at which to begin drawing the
      * text, in pixels.
      * \param y The y-coordinate of the point at which to begin drawing the
@@ -143,8 +249,8 @@ public:
      * method to draw the text with the characters filled with color rather than
      * having just their outlines drawn.
      *
-     * \param text The text to draw using the current font, textAlign,
-     * textBaseline, and direction values.
+     * \param text The text to draw, in UTF-8, using the current font,
+     * textAlign, textBaseline, and direction values.
      * \param x The x axis of the coordinate for the text starting point.
      * \param y The y axis of the coordinate for the text starting point.
      * \param maxWidth The maximum width to draw. If specified, and the string
@@ -155,6 +261,17 @@ public:
      */
     void strokeText(const char *text, float x, float y, float maxWidth = FLT_MAX);
 
+    /*!
+     * \brief measureText returns a TextMetrics object that contains
+     * information about the measured text (such as its width for example),
+     * laid out with the current font, textAlign, textBaseline and direction.
+     * The layout is cached, and shared with fillText() and strokeText() calls
+     * drawing the same string without maxWidth.
+     *
+     * \param text The text to measure, in UTF-8.
+     */
+    TextMetrics measureText(const char *text);
+
 
 
     /*!
@@ -324,6 +441,23 @@ public:
      */
     void fill(Path2D &path, FillRule fillRule = FillRule::nonzero);
 
+    /*!
+     * \brief fillInstances fills count copies of the given path, each one
+     * transformed by transforms[i] then by the current transform. The path is
+     * tessellated once, and the copies are drawn with a single instanced draw
+     * call when the GL version supports it.
+     *
+     * \param path A Path2D path to fill.
+     * \param transforms The transform of each copy.
+     * \param colors The color of each copy, or nullptr to fill every copy with
+     * the color of the fill style.
+     * \param count The number of copies.
+     *
+     * \note The copies are filled with plain colors using the non-zero
+     * winding rule, without shadows.
+     */
+    void fillInstances(Path2D &path, const SVGMatrix *transforms, const Color *colors, size_t count);
+
     /*!
      * \brief stroke strokes the current or given path with the current stroke
      * style using the non-zero winding rule.
@@ -23,6 +23,8 @@
  **/
 #include <Tunis.h>
 
+#include <cmath>
+
 namespace tunis
 {
 
@@ -36,6 +38,47 @@ inline void Context::closePath()
     currentPath.closePath();
 }
 
+inline void Context::scale(float x, float y)
+{
+    transform(x, 0.0f, 0.0f, y, 0.0f, 0.0f);
+}
+
+inline void Context::rotate(float angle)
+{
+    float c = std::cos(angle);
+    float s = std::sin(angle);
+    transform(c, s, -s, c, 0.0f, 0.0f);
+}
+
+inline void Context::translate(float x, float y)
+{
+    transform(1.0f, 0.0f, 0.0f, 1.0f, x, y);
+}
+
+inline void Context::transform(float a, float b, float c, float d, float e, float f)
+{
+    // currentTransform holds the rows (a c e) and (b d f).
+    glm::vec3 &m0 = currentTransform[0];
+    glm::vec3 &m1 = currentTransform[1];
+
+    glm::vec3 r0(m0.x * a + m0.y * b, m0.x * c + m0.y * d, m0.x * e + m0.y * f + m0.z);
+    glm::vec3 r1(m1.x * a + m1.y * b, m1.x * c + m1.y * d, m1.x * e + m1.y * f + m1.z);
+
+    m0 = r0;
+    m1 = r1;
+}
+
+inline void Context::setTransform(float a, float b, float c, float d, float e, float f)
+{
+    currentTransform[0] = glm::vec3(a, c, e);
+    currentTransform[1] = glm::vec3(b, d, f);
+}
+
+inline void Context::resetTransform()
+{
+    currentTransform = SVGMatrix(1.0f);
+}
+
 inline void Context::fillRect(float x, float y, float width, float height)
 {
     rect(x, y, width, height);
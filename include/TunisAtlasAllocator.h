@@ -0,0 +1,127 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISATLASALLOCATOR_H
+#define TUNISATLASALLOCATOR_H
+
+#include <cinttypes>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <set>
+
+namespace tunis
+{
+    namespace detail
+    {
+        /*!
+         * \brief AtlasAllocator packs rectangles into a texture atlas with
+         * shelves: horizontal bands stacked from the top, each as tall as the
+         * rectangles it holds, rounded up to ShelfRounding pixels.
+         *
+         * Every free span of every shelf is indexed by shelf height then
+         * width, so allocate() and deallocate() both run in O(log n). Freed
+         * spans merge with their free neighbours, and the empty shelves at the
+         * bottom of the stack are given back to the atlas.
+         */
+        class AtlasAllocator
+        {
+        public:
+
+            enum
+            {
+                ShelfRounding = 8
+            };
+
+            AtlasAllocator(int32_t width, int32_t height);
+
+            /*!
+             * \brief allocate reserves a width by height rectangle.
+             *
+             * \return false if there is no room left for it, in which case x
+             * and y are left untouched.
+             */
+            bool allocate(int32_t width, int32_t height, int32_t &x, int32_t &y);
+
+            /*!
+             * \brief deallocate gives back a rectangle previously returned by
+             * allocate(), with the same width.
+             */
+            void deallocate(int32_t x, int32_t y, int32_t width);
+
+            /*!
+             * \brief clear deallocates everything.
+             */
+            void clear();
+
+            int32_t width() const;
+            int32_t height() const;
+
+            /*!
+             * \brief usedArea returns the area of the allocated rectangles,
+             * shelf rounding included, in pixels.
+             */
+            size_t usedArea() const;
+
+            /*!
+             * \brief fragmentation returns the share of the free area that is
+             * scattered in the gaps of the shelves, which only fits rectangles
+             * about as tall as those shelves, rather than left untouched below
+             * the last shelf. 0 is a perfectly compact atlas.
+             */
+            float fragmentation() const;
+
+        private:
+
+            struct Span
+            {
+                int32_t height; // of its shelf.
+                int32_t width;
+                int32_t y;
+                int32_t x;
+
+                bool operator<(const Span &other) const;
+            };
+
+            struct Shelf
+            {
+                int32_t height;
+                std::map<int32_t, int32_t> spans; // free spans, x to width.
+            };
+
+            void addSpan(Shelf &shelf, int32_t y, int32_t x, int32_t width);
+            void removeSpan(Shelf &shelf, int32_t y, std::map<int32_t, int32_t>::iterator span);
+
+            int32_t w, h;
+            int32_t top; // bottom of the last shelf.
+            size_t used;
+            size_t shelfFreeArea;
+            std::map<int32_t, Shelf> shelves; // by y.
+            std::set<Span> spans; // every free span, by shelf height then width.
+        };
+    }
+}
+
+#include "TunisAtlasAllocator.inl"
+
+#endif // TUNISATLASALLOCATOR_H
@@ -0,0 +1,216 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisAtlasAllocator.h>
+
+#include <cassert>
+
+namespace tunis
+{
+    namespace detail
+    {
+        inline bool AtlasAllocator::Span::operator<(const Span &other) const
+        {
+            if (height != other.height) return height < other.height;
+            if (width != other.width) return width < other.width;
+            if (y != other.y) return y < other.y;
+            return x < other.x;
+        }
+
+        inline AtlasAllocator::AtlasAllocator(int32_t width, int32_t height) :
+            w(width),
+            h(height)
+        {
+            clear();
+        }
+
+        inline bool AtlasAllocator::allocate(int32_t width, int32_t height, int32_t &x, int32_t &y)
+        {
+            if (width <= 0 || height <= 0 || width > w || height > h)
+            {
+                return false;
+            }
+
+            int32_t shelfHeight = (height + ShelfRounding - 1) / ShelfRounding * ShelfRounding;
+
+            // the narrowest span wide enough in the shortest shelf tall
+            // enough, without wasting more than half of the shelf height.
+            auto it = spans.lower_bound(Span{shelfHeight, width, 0, 0});
+            while (it != spans.end() && it->height <= shelfHeight + shelfHeight / 2)
+            {
+                if (it->width >= width)
+                {
+                    break;
+                }
+
+                // landed on the narrow spans of a taller shelf height: look
+                // for the wide enough ones of that height first.
+                auto wide = spans.lower_bound(Span{it->height, width, 0, 0});
+                if (wide != spans.end() && wide->height == it->height)
+                {
+                    it = wide;
+                    break;
+                }
+
+                // no span wide enough in this shelf height, try the next one.
+                it = spans.lower_bound(Span{it->height + 1, width, 0, 0});
+            }
+
+            if (it != spans.end() && it->height <= shelfHeight + shelfHeight / 2)
+            {
+                Span span = *it;
+                Shelf &shelf = shelves[span.y];
+                removeSpan(shelf, span.y, shelf.spans.find(span.x));
+
+                if (span.width > width)
+                {
+                    addSpan(shelf, span.y, span.x + width, span.width - width);
+                }
+
+                x = span.x;
+                y = span.y;
+                used += static_cast<size_t>(width) * span.height;
+                return true;
+            }
+
+            // open a new shelf below the last one.
+            if (top + shelfHeight > h)
+            {
+                return false;
+            }
+
+            Shelf &shelf = shelves[top];
+            shelf.height = shelfHeight;
+            if (w > width)
+            {
+                addSpan(shelf, top, width, w - width);
+            }
+
+            x = 0;
+            y = top;
+            top += shelfHeight;
+            used += static_cast<size_t>(width) * shelfHeight;
+            return true;
+        }
+
+        inline void AtlasAllocator::deallocate(int32_t x, int32_t y, int32_t width)
+        {
+            auto shelfIt = shelves.find(y);
+            assert(shelfIt != shelves.end());
+            if (shelfIt == shelves.end())
+            {
+                return;
+            }
+
+            Shelf &shelf = shelfIt->second;
+            used -= static_cast<size_t>(width) * shelf.height;
+
+            // merge with the free spans right before and right after.
+            auto next = shelf.spans.lower_bound(x);
+            if (next != shelf.spans.end() && next->first == x + width)
+            {
+                width += next->second;
+                removeSpan(shelf, y, next);
+            }
+
+            auto prev = shelf.spans.lower_bound(x);
+            if (prev != shelf.spans.begin())
+            {
+                --prev;
+                if (prev->first + prev->second == x)
+                {
+                    x = prev->first;
+                    width += prev->second;
+                    removeSpan(shelf, y, prev);
+                }
+            }
+
+            addSpan(shelf, y, x, width);
+
+            // give the empty shelves at the bottom of the stack back, so they
+            // can be reopened at any height.
+            while (shelves.size() > 0)
+            {
+                auto last = std::prev(shelves.end());
+                Shelf &lastShelf = last->second;
+                if (lastShelf.spans.size() != 1 || lastShelf.spans.begin()->second != w)
+                {
+                    break;
+                }
+
+                removeSpan(lastShelf, last->first, lastShelf.spans.begin());
+                top = last->first;
+                shelves.erase(last);
+            }
+        }
+
+        inline void AtlasAllocator::clear()
+        {
+            top = 0;
+            used = 0;
+            shelfFreeArea = 0;
+            shelves.clear();
+            spans.clear();
+        }
+
+        inline int32_t AtlasAllocator::width() const
+        {
+            return w;
+        }
+
+        inline int32_t AtlasAllocator::height() const
+        {
+            return h;
+        }
+
+        inline size_t AtlasAllocator::usedArea() const
+        {
+            return used;
+        }
+
+        inline float AtlasAllocator::fragmentation() const
+        {
+            size_t freeArea = static_cast<size_t>(w) * h - used;
+            if (freeArea == 0)
+            {
+                return 0.0f;
+            }
+
+            return static_cast<float>(shelfFreeArea) / static_cast<float>(freeArea);
+        }
+
+        inline void AtlasAllocator::addSpan(Shelf &shelf, int32_t y, int32_t x, int32_t width)
+        {
+            shelf.spans[x] = width;
+            spans.insert(Span{shelf.height, width, y, x});
+            shelfFreeArea += static_cast<size_t>(width) * shelf.height;
+        }
+
+        inline void AtlasAllocator::removeSpan(Shelf &shelf, int32_t y, std::map<int32_t, int32_t>::iterator span)
+        {
+            spans.erase(Span{shelf.height, span->second, y, span->first});
+            shelfFreeArea -= static_cast<size_t>(span->second) * shelf.height;
+            shelf.spans.erase(span);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISFRAMESTATS_H
+#define TUNISFRAMESTATS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace tunis
+{
+
+/*!
+ * \brief FrameStats holds the counters collected by the backend while the last
+ * frame was flushed by Context::endFrame().
+ */
+struct FrameStats
+{
+    double uploadTime = 0.0;   //!< CPU time spent handing vertex and index data over to GL, in milliseconds.
+    size_t vertexCount = 0;    //!< vertices streamed to GL.
+    size_t indexCount = 0;     //!< indices streamed to GL.
+    size_t instanceCount = 0;  //!< instances streamed to GL by instanced draws.
+    size_t drawCallCount = 0;  //!< draw calls issued.
+    size_t unsortedDrawCallCount = 0; //!< draw calls that would have been issued without reordering the draws (estimated).
+    double tessellationTime = 0.0;      //!< time spent tessellating the draws missing from the cache, in milliseconds.
+    size_t tessellationCacheHits = 0;   //!< draws that reused a cached tessellation.
+    size_t tessellationCacheMisses = 0; //!< draws that had to be tessellated.
+    size_t tessellationCacheSize = 0;   //!< memory retained by the tessellation cache, in bytes.
+    size_t atlasMemory = 0;             //!< texture memory of the atlas pages, in bytes.
+    size_t atlasEvictions = 0;          //!< images evicted from the atlas to make room for others.
+    std::vector<float> atlasPageOccupancy; //!< share of each atlas page taken by images, from 0 to 1.
+    size_t imageUploadBytes = 0;        //!< image pixels handed over to GL, in bytes.
+    size_t pendingImageUploads = 0;     //!< images waiting for their turn to be uploaded, past the budget.
+    size_t textLayoutCacheHits = 0;     //!< strings drawn or measured with a cached layout.
+    size_t textLayoutCacheMisses = 0;   //!< strings that had to be laid out.
+    size_t textLayoutCacheSize = 0;     //!< runs retained by the text layout cache.
+};
+
+}
+
+#endif // TUNISFRAMESTATS_H
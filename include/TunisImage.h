@@ -24,6 +24,7 @@
 #ifndef TUNISIMAGE_H
 #define TUNISIMAGE_H
 
+#include <TunisPixelBuffer.h>
 #include <TunisSOA.h>
 #include <TunisRect.h>
 
@@ -40,24 +41,32 @@ namespace tunis
     {
         class ContextPriv;
         class Texture;
+        class ImageUploader;
     }
 
-    class Image : public RefCountedSOA<std::string, std::vector<uint8_t>, Rect<int32_t>, Rect<int32_t>, detail::Texture*>
+    class Image : public RefCountedSOA<std::string, detail::PixelBuffer, Rect<int32_t>, Rect<int32_t>, detail::Texture*, uint64_t, bool, bool>
     {
         inline std::string &source() { return get<0>(); }
-        inline std::vector<uint8_t> &data() { return get<1>(); }
+        inline detail::PixelBuffer &data() { return get<1>(); }
         inline Rect<int32_t> &bounds() { return get<2>(); }
         inline Rect<int32_t> &paddedBounds() { return get<3>(); }
         inline detail::Texture* &parent() { return get<4>(); }
+        inline uint64_t &lastDrawnFrame() { return get<5>(); }
+        inline bool &loading() { return get<6>(); }
+        inline bool &failed() { return get<7>(); } // could not be decoded from source().
 
         inline const std::string &source() const { return get<0>(); }
-        inline const std::vector<uint8_t> &data() const { return get<1>(); }
+        inline const detail::PixelBuffer &data() const { return get<1>(); }
         inline const Rect<int32_t> &bounds() const { return get<2>(); }
         inline const Rect<int32_t> &paddedBounds() const { return get<3>(); }
         inline const detail::Texture* parent() const { return get<4>(); }
+        inline const uint64_t &lastDrawnFrame() const { return get<5>(); }
+        inline const bool &loading() const { return get<6>(); }
+        inline const bool &failed() const { return get<7>(); }
 
         friend detail::ContextPriv;
         friend detail::Texture;
+        friend detail::ImageUploader;
 
         class Source
         {
@@ -71,6 +80,12 @@ namespace tunis
             operator const std::string &() const;
         };
 
+        /*!
+         * \brief sourceChanged decodes the image at source() on the executor
+         * of ctx. The worker never touches the image: the SoA storage is not
+         * thread-safe by default, so the decoded pixels are handed back to
+         * the render thread, where dataChanged() adds them to the atlas.
+         */
         void sourceChanged(detail::ContextPriv *ctx);
         void dataChanged(detail::ContextPriv *ctx);
 
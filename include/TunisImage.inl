@@ -69,20 +69,26 @@ namespace tunis
         src(this)
     {
         source().resize(0);
-        data().resize(0);
+        data().reset();
         bounds() = Rect<int32_t>(0, 0, 1, 1);
         paddedBounds() = Rect<int32_t>();
         parent() = nullptr;
+        lastDrawnFrame() = 0;
+        loading() = false;
+        failed() = false;
     }
 
     inline Image::Image(std::string url) :
         src(this)
     {
         source() = std::move(url);
-        data().resize(0);
+        data().reset();
         bounds() = Rect<int32_t>(0, 0, 1, 1);
         paddedBounds() = Rect<int32_t>();
         parent() = nullptr;
+        lastDrawnFrame() = 0;
+        loading() = false;
+        failed() = false;
         detail::enqueueTask(&Image::sourceChanged, this);
     }
 
@@ -0,0 +1,163 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISJOBSYSTEM_H
+#define TUNISJOBSYSTEM_H
+
+#include <concurrentqueue.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tunis
+{
+
+/*!
+ * \brief Executor runs the background work of a Context: tessellation, stroke
+ * generation and image decoding. Derive from it to run that work on the host
+ * application's own thread pool, and hand it to Context::setExecutor().
+ */
+class Executor
+{
+public:
+
+    using Task = std::function<void()>;
+
+    virtual ~Executor() {}
+
+    /*!
+     * \brief concurrency returns how many threads may run tasks at the same
+     * time, including the thread waiting on a parallelFor().
+     */
+    virtual size_t concurrency() const = 0;
+
+    /*!
+     * \brief submit runs task asynchronously. Must be thread-safe.
+     */
+    virtual void submit(Task task) = 0;
+};
+
+/*!
+ * \brief JobSystem is the built-in Executor: a bounded pool of worker threads,
+ * each with its own task queue. Idle workers steal tasks from the queues of
+ * the others.
+ */
+class JobSystem : public Executor
+{
+public:
+
+    /*!
+     * \brief JobSystem starts threadCount worker threads. When threadCount is
+     * 0, one worker per hardware thread but one is started, since the thread
+     * waiting on a parallelFor() takes part in it.
+     */
+    explicit JobSystem(size_t threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    size_t concurrency() const override;
+    void submit(Task task) override;
+
+private:
+
+    void run(size_t workerId);
+    bool tryPop(size_t workerId, Task &task);
+
+    static size_t &currentWorkerId();
+    static JobSystem *&currentJobSystem();
+
+    std::vector<std::thread> m_threads;
+    std::vector<std::unique_ptr<moodycamel::ConcurrentQueue<Task>>> m_queues;
+    std::atomic<size_t> m_nextQueue;
+    std::atomic<size_t> m_pendingCount;
+    std::atomic<bool> m_running;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+};
+
+namespace detail
+{
+    /*!
+     * \brief ParallelFor calls body(index, participant) for every index in
+     * [0, count), on up to executor.concurrency() threads including the
+     * calling one, and returns once every call returned. participant is
+     * unique to each thread taking part, and lower than
+     * executor.concurrency(), so it can be used to index per-thread scratch
+     * memory.
+     *
+     * The state shared with the helper threads is kept from one call to the
+     * next, and the helper tasks only capture a pointer to it, so a warmed up
+     * ParallelFor does not allocate. It must only be called from one thread
+     * at a time.
+     */
+    class ParallelFor
+    {
+    public:
+
+        ParallelFor() = default;
+        ~ParallelFor();
+
+        ParallelFor(const ParallelFor &) = delete;
+        ParallelFor &operator=(const ParallelFor &) = delete;
+
+        template <typename Body>
+        void operator()(Executor &executor, size_t count, const Body &body);
+
+    private:
+
+        struct Job
+        {
+            void (*invoke)(const void *body, size_t index, size_t participant);
+            const void *body;
+            size_t count;
+            std::atomic<size_t> nextIndex;
+            std::atomic<size_t> doneCount;
+            std::atomic<size_t> participantCount;
+            std::atomic<size_t> helperCount; // submitted, and not done yet.
+        };
+
+        template <typename Body>
+        static void invoke(const void *body, size_t index, size_t participant);
+
+        void run(Executor &executor, size_t count, const void *body, void (*invoke)(const void*, size_t, size_t));
+        static void work(Job &job, size_t participant);
+
+        // helpers that start late may still look at their job after the call
+        // returned, so a job is only reused once its helpers are all done.
+        std::deque<Job> m_jobs;
+    };
+}
+
+}
+
+#include <TunisJobSystem.inl>
+
+#endif // TUNISJOBSYSTEM_H
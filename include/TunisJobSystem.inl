@@ -0,0 +1,230 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisJobSystem.h>
+
+#include <algorithm>
+
+namespace tunis
+{
+
+inline JobSystem::JobSystem(size_t threadCount) :
+    m_nextQueue(0),
+    m_pendingCount(0),
+    m_running(true)
+{
+    if (threadCount == 0)
+    {
+        size_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        m_queues.emplace_back(new moodycamel::ConcurrentQueue<Task>());
+    }
+
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&JobSystem::run, this, i);
+    }
+}
+
+inline JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_wakeUp.notify_all();
+
+    for (size_t i = 0; i < m_threads.size(); ++i)
+    {
+        m_threads[i].join();
+    }
+}
+
+inline size_t JobSystem::concurrency() const
+{
+    return m_threads.size() + 1;
+}
+
+inline void JobSystem::submit(Task task)
+{
+    // workers push to their own queue, everybody else spreads their tasks.
+    size_t queueId = currentJobSystem() == this ?
+                currentWorkerId() :
+                m_nextQueue++ % m_queues.size();
+
+    m_queues[queueId]->enqueue(std::move(task));
+    ++m_pendingCount;
+
+    {
+        // do not notify between a worker's check and its wait.
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_wakeUp.notify_one();
+}
+
+inline bool JobSystem::tryPop(size_t workerId, Task &task)
+{
+    for (size_t i = 0; i < m_queues.size(); ++i)
+    {
+        // start with our own queue, then steal from the next ones.
+        if (m_queues[(workerId + i) % m_queues.size()]->try_dequeue(task))
+        {
+            --m_pendingCount;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline void JobSystem::run(size_t workerId)
+{
+    currentJobSystem() = this;
+    currentWorkerId() = workerId;
+
+    Task task;
+    while (true)
+    {
+        if (tryPop(workerId, task))
+        {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wakeUp.wait(lock, [this]{ return !m_running || m_pendingCount > 0; });
+
+        if (!m_running)
+        {
+            break;
+        }
+    }
+}
+
+inline size_t &JobSystem::currentWorkerId()
+{
+    static thread_local size_t workerId = 0;
+    return workerId;
+}
+
+inline JobSystem *&JobSystem::currentJobSystem()
+{
+    static thread_local JobSystem *jobSystem = nullptr;
+    return jobSystem;
+}
+
+namespace detail
+{
+    inline ParallelFor::~ParallelFor()
+    {
+        for (Job &job : m_jobs)
+        {
+            while (job.helperCount > 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template <typename Body>
+    inline void ParallelFor::operator()(Executor &executor, size_t count, const Body &body)
+    {
+        run(executor, count, &body, &ParallelFor::invoke<Body>);
+    }
+
+    template <typename Body>
+    inline void ParallelFor::invoke(const void *body, size_t index, size_t participant)
+    {
+        (*static_cast<const Body*>(body))(index, participant);
+    }
+
+    inline void ParallelFor::work(Job &job, size_t participant)
+    {
+        size_t index;
+        while ((index = job.nextIndex++) < job.count)
+        {
+            job.invoke(job.body, index, participant);
+            ++job.doneCount;
+        }
+    }
+
+    inline void ParallelFor::run(Executor &executor, size_t count, const void *body, void (*invoke)(const void*, size_t, size_t))
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        Job *job = nullptr;
+        for (Job &candidate : m_jobs)
+        {
+            if (candidate.helperCount == 0)
+            {
+                job = &candidate;
+                break;
+            }
+        }
+
+        if (!job)
+        {
+            m_jobs.emplace_back();
+            job = &m_jobs.back();
+            job->helperCount = 0;
+        }
+
+        size_t helperCount = std::min(executor.concurrency(), count) - 1;
+
+        job->invoke = invoke;
+        job->body = body;
+        job->count = count;
+        job->nextIndex = 0;
+        job->doneCount = 0;
+        job->participantCount = 1; // the calling thread is participant 0.
+        job->helperCount = helperCount;
+
+        for (size_t i = 0; i < helperCount; ++i)
+        {
+            // small enough for the local storage of the task.
+            executor.submit([job]()
+            {
+                work(*job, job->participantCount++);
+                --job->helperCount;
+            });
+        }
+
+        work(*job, 0);
+
+        // wait for the indices picked up by the helpers.
+        while (job->doneCount < count)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+}
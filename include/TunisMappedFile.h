@@ -0,0 +1,78 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISMAPPEDFILE_H
+#define TUNISMAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tunis
+{
+    namespace detail
+    {
+        /*!
+         * \brief MappedFile maps a whole file in memory, read-only. Its pages
+         * are loaded on first access and shared with every other process, or
+         * context, mapping the same file.
+         */
+        class MappedFile
+        {
+        public:
+
+            MappedFile();
+            ~MappedFile();
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            /*!
+             * \brief open maps the file at path, unmapping the previous one.
+             *
+             * \return false if it could not be mapped. Empty files cannot.
+             */
+            bool open(const std::string &path);
+
+            void close();
+
+            const uint8_t *data() const;
+            size_t size() const;
+
+        private:
+
+            const uint8_t *address;
+            size_t length;
+#if defined(_WIN32)
+            void *file;
+            void *mapping;
+#else
+            int fd;
+#endif
+        };
+    }
+}
+
+#include "TunisMappedFile.inl"
+
+#endif // TUNISMAPPEDFILE_H
@@ -0,0 +1,183 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisMappedFile.h>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tunis
+{
+    namespace detail
+    {
+        inline MappedFile::MappedFile() :
+            address(nullptr),
+            length(0),
+#if defined(_WIN32)
+            file(INVALID_HANDLE_VALUE),
+            mapping(nullptr)
+#else
+            fd(-1)
+#endif
+        {
+        }
+
+        inline MappedFile::~MappedFile()
+        {
+            close();
+        }
+
+#if defined(_WIN32)
+
+        inline bool MappedFile::open(const std::string &path)
+        {
+            close();
+
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return false;
+            }
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+            {
+                close();
+                return false;
+            }
+
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping)
+            {
+                close();
+                return false;
+            }
+
+            address = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!address)
+            {
+                close();
+                return false;
+            }
+
+            length = static_cast<size_t>(fileSize.QuadPart);
+            return true;
+        }
+
+        inline void MappedFile::close()
+        {
+            if (address)
+            {
+                UnmapViewOfFile(address);
+                address = nullptr;
+            }
+
+            if (mapping)
+            {
+                CloseHandle(mapping);
+                mapping = nullptr;
+            }
+
+            if (file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(file);
+                file = INVALID_HANDLE_VALUE;
+            }
+
+            length = 0;
+        }
+
+#else
+
+        inline bool MappedFile::open(const std::string &path)
+        {
+            close();
+
+            fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                return false;
+            }
+
+            struct stat status;
+            if (fstat(fd, &status) != 0 || status.st_size == 0)
+            {
+                close();
+                return false;
+            }
+
+            void *mapped = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                close();
+                return false;
+            }
+
+            address = static_cast<const uint8_t*>(mapped);
+            length = static_cast<size_t>(status.st_size);
+            return true;
+        }
+
+        inline void MappedFile::close()
+        {
+            if (address)
+            {
+                munmap(const_cast<uint8_t*>(address), length);
+                address = nullptr;
+            }
+
+            if (fd >= 0)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+
+            length = 0;
+        }
+
+#endif
+
+        inline const uint8_t *MappedFile::data() const
+        {
+            return address;
+        }
+
+        inline size_t MappedFile::size() const
+        {
+            return length;
+        }
+    }
+}
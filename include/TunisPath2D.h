@@ -38,6 +38,9 @@
 
 #include <MPE_fastpoly2tri.h>
 
+#include <cstring>
+#include <deque>
+
 
 namespace tunis
 {
@@ -120,38 +123,124 @@ using BorderPointArray = std::vector<glm::vec2>;
 
 struct SubPath2D
 {
-    MPEPolyContext polyContext;
-    MemPool mempool;
     ContourPointArray points;
     BorderPointArray innerPoints;
     BorderPointArray outerPoints;
     bool closed;
 };
-using SubPath2DArray = std::array<SubPath2D, 128>;
+
+/*!
+ * \brief SubPath2DArena holds the sub-paths of the path currently being
+ * tessellated. Paths only record their commands; their sub-paths are generated
+ * into an arena, which is reset for the next path. Sub-paths are recycled
+ * along with the capacity of their arrays, so the memory used scales with the
+ * largest path tessellated rather than with the number of paths alive, and
+ * there is no limit on the number of sub-paths.
+ */
+class SubPath2DArena
+{
+public:
+
+    inline SubPath2D &operator[](size_t idx) { return subPaths[idx]; }
+    inline const SubPath2D &operator[](size_t idx) const { return subPaths[idx]; }
+
+    inline size_t size() const { return count; }
+
+    /*!
+     * \brief add returns the index of a new empty sub-path.
+     */
+    inline size_t add()
+    {
+        if (count == subPaths.size())
+        {
+            // a deque does not move the existing sub-paths when growing.
+            subPaths.emplace_back();
+        }
+
+        SubPath2D &subPath = subPaths[count];
+        subPath.points.resize(0);
+        subPath.innerPoints.resize(0);
+        subPath.outerPoints.resize(0);
+        subPath.closed = false;
+
+        return count++;
+    }
+
+    inline void reset() { count = 0; }
+
+    /*!
+     * \brief rebuild moves the current sub-paths aside, where they remain
+     * readable with previous(), and starts over with no sub-paths.
+     *
+     * \return the number of sub-paths moved aside.
+     */
+    inline size_t rebuild()
+    {
+        std::swap(subPaths, previousSubPaths);
+        size_t previousCount = count;
+        count = 0;
+        return previousCount;
+    }
+
+    inline const SubPath2D &previous(size_t idx) const { return previousSubPaths[idx]; }
+
+    /*!
+     * \brief polyMemory returns size bytes of zero initialized working memory
+     * for fast-poly2tri, valid until the next call. The memory is only
+     * reallocated when it needs to grow, and only the bytes that were handed
+     * out before, and are handed out again, get cleared.
+     */
+    inline void *polyMemory(size_t size)
+    {
+        if (size > polyPool.size())
+        {
+            polyPool.resize(size, 0); // new bytes are zeroed.
+        }
+
+        // fast-poly2tri may have written anywhere in the blocks it was given,
+        // so no assumption is made on how much of them it actually used.
+        // Bytes past size stay dirty, for a later and larger call.
+        memset(polyPool.data(), 0, size < polyPoolDirty ? size : polyPoolDirty);
+
+        if (size > polyPoolDirty)
+        {
+            polyPoolDirty = size;
+        }
+
+        return polyPool.data();
+    }
+
+    /*!
+     * \brief polyContext is shared by the sub-paths, which get triangulated
+     * one at a time.
+     */
+    MPEPolyContext polyContext;
+
+private:
+    std::deque<SubPath2D> subPaths;
+    std::deque<SubPath2D> previousSubPaths;
+    size_t count = 0;
+    MemPool polyPool;
+    size_t polyPoolDirty = 0; // the most bytes of polyPool handed out.
+};
 
 }
 
 class Path2D : public RefCountedSOA<
         detail::PathCommandArray,
-        detail::SubPath2DArray,
-        size_t,
         uint8_t,
         glm::vec2,
         glm::vec2>
 {
     inline detail::PathCommandArray &commands() { return get<0>(); }
-    inline detail::SubPath2DArray &subPaths() { return get<1>(); }
-    inline size_t &subPathCount() { return get<2>(); }
-    inline uint8_t &dirty() { return get<3>(); }
-    inline glm::vec2 &boundTopLeft() { return get<4>(); }
-    inline glm::vec2 &boundBottomRight() { return get<5>(); }
+    inline uint8_t &dirty() { return get<1>(); }
+    inline glm::vec2 &boundTopLeft() { return get<2>(); }
+    inline glm::vec2 &boundBottomRight() { return get<3>(); }
 
     inline const detail::PathCommandArray &commands() const { return get<0>(); }
-    inline const detail::SubPath2DArray &subPaths() const { return get<1>(); }
-    inline const size_t &subPathCount() const { return get<2>(); }
-    inline const uint8_t &dirty() const { return get<3>(); }
-    inline const glm::vec2 &boundTopLeft() const { return get<4>(); }
-    inline const glm::vec2 &boundBottomRight() const { return get<5>(); }
+    inline const uint8_t &dirty() const { return get<1>(); }
+    inline const glm::vec2 &boundTopLeft() const { return get<2>(); }
+    inline const glm::vec2 &boundBottomRight() const { return get<3>(); }
 
     friend detail::ContextPriv;
 
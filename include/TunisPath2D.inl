@@ -36,7 +36,6 @@ inline Path2D::Path2D()
 inline void Path2D::reset()
 {
     commands().resize(0);
-    subPathCount() = 0;
     dirty() = false;
     boundTopLeft() = glm::vec2(FLT_MAX);
     boundBottomRight() = glm::vec2(-FLT_MAX);
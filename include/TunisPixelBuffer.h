@@ -0,0 +1,78 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISPIXELBUFFER_H
+#define TUNISPIXELBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tunis
+{
+    namespace detail
+    {
+        /*!
+         * \brief PixelBuffer owns the RGBA pixels of an image until they are
+         * uploaded. It adopts the buffer of the decoder as is, along with the
+         * function releasing it, so the decoded pixels are never copied.
+         */
+        class PixelBuffer
+        {
+        public:
+
+            using Release = void (*)(void *pixels);
+
+            PixelBuffer();
+            PixelBuffer(uint8_t *pixels, size_t size, Release release);
+            ~PixelBuffer();
+
+            PixelBuffer(const PixelBuffer &other);
+            PixelBuffer &operator=(const PixelBuffer &other);
+            PixelBuffer(PixelBuffer &&other) noexcept;
+            PixelBuffer &operator=(PixelBuffer &&other) noexcept;
+
+            /*!
+             * \brief assign replaces the pixels with a copy of [first, last).
+             */
+            void assign(const uint8_t *first, const uint8_t *last);
+
+            /*!
+             * \brief reset releases the pixels.
+             */
+            void reset();
+
+            const uint8_t *data() const;
+            size_t size() const;
+
+        private:
+
+            uint8_t *pixels;
+            size_t length;
+            Release release;
+        };
+    }
+}
+
+#include "TunisPixelBuffer.inl"
+
+#endif // TUNISPIXELBUFFER_H
@@ -0,0 +1,126 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisPixelBuffer.h>
+
+#include <cstring>
+#include <utility>
+
+namespace tunis
+{
+    namespace detail
+    {
+        static inline void deleteCopiedPixels(void *pixels)
+        {
+            delete[] static_cast<uint8_t*>(pixels);
+        }
+
+        inline PixelBuffer::PixelBuffer() :
+            pixels(nullptr),
+            length(0),
+            release(nullptr)
+        {
+        }
+
+        inline PixelBuffer::PixelBuffer(uint8_t *pixels, size_t size, Release release) :
+            pixels(pixels),
+            length(size),
+            release(release)
+        {
+        }
+
+        inline PixelBuffer::~PixelBuffer()
+        {
+            reset();
+        }
+
+        inline PixelBuffer::PixelBuffer(const PixelBuffer &other) :
+            PixelBuffer()
+        {
+            assign(other.data(), other.data() + other.size());
+        }
+
+        inline PixelBuffer &PixelBuffer::operator=(const PixelBuffer &other)
+        {
+            if (this != &other)
+            {
+                assign(other.data(), other.data() + other.size());
+            }
+            return *this;
+        }
+
+        inline PixelBuffer::PixelBuffer(PixelBuffer &&other) noexcept :
+            pixels(other.pixels),
+            length(other.length),
+            release(other.release)
+        {
+            other.pixels = nullptr;
+            other.length = 0;
+            other.release = nullptr;
+        }
+
+        inline PixelBuffer &PixelBuffer::operator=(PixelBuffer &&other) noexcept
+        {
+            std::swap(pixels, other.pixels);
+            std::swap(length, other.length);
+            std::swap(release, other.release);
+            return *this;
+        }
+
+        inline void PixelBuffer::assign(const uint8_t *first, const uint8_t *last)
+        {
+            reset();
+
+            size_t size = static_cast<size_t>(last - first);
+            if (size > 0)
+            {
+                pixels = new uint8_t[size];
+                memcpy(pixels, first, size);
+                length = size;
+                release = &deleteCopiedPixels;
+            }
+        }
+
+        inline void PixelBuffer::reset()
+        {
+            if (pixels && release)
+            {
+                release(pixels);
+            }
+
+            pixels = nullptr;
+            length = 0;
+            release = nullptr;
+        }
+
+        inline const uint8_t *PixelBuffer::data() const
+        {
+            return pixels;
+        }
+
+        inline size_t PixelBuffer::size() const
+        {
+            return length;
+        }
+    }
+}
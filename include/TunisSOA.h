@@ -24,7 +24,7 @@
 #ifndef TUNISSOA_H
 #define TUNISSOA_H
 
-#include <soa.h>
+#include <TunisSOAStorage.h>
 
 namespace tunis
 {
@@ -75,15 +75,17 @@ namespace tunis
      * (notice that I renamed MyVector to MyVectorArray for better clarity)
      *
      * if done correctly, you shouldn't need to use std::vector anywhere.
+     *
+     * By default, instances must only be created, copied and destroyed from a
+     * single thread. Define TUNIS_THREAD_SAFE_SOA to switch every
+     * RefCountedSOA to a thread-safe storage (see detail::ConcurrentSOAStorage).
      */
     template <typename... Elements>
     class RefCountedSOA
     {
     public:
-        using refid_t = uint32_t;
-        using refcount_t = uint32_t;
-        enum {_refCount = sizeof...(Elements) };
-
+        using refid_t = detail::refid_t;
+        using refcount_t = detail::refcount_t;
         RefCountedSOA();
         RefCountedSOA(const RefCountedSOA &other);
         RefCountedSOA(RefCountedSOA &&other);
@@ -96,6 +98,11 @@ namespace tunis
 
         refid_t getId() const;
 
+        /*!
+         * \brief getRefCount returns how many instances share this slice.
+         */
+        refcount_t getRefCount() const;
+
         template <typename T> T clone();
 
         static void reserve(size_t size);
@@ -109,8 +116,12 @@ namespace tunis
         typename SoA<Elements..., refcount_t>::template NthTypeOf<ArrayIndex>& get() const;
 
     private:
-        static SoA<Elements..., refcount_t> _soa;
-        static std::vector<refid_t> _available;
+#if defined(TUNIS_THREAD_SAFE_SOA)
+        using Storage = detail::ConcurrentSOAStorage<Elements...>;
+#else
+        using Storage = detail::SOAStorage<Elements...>;
+#endif
+        static Storage _storage;
         refid_t _id;
     };
 
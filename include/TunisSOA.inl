@@ -26,43 +26,29 @@
 namespace tunis
 {
     template <typename... Elements>
-    inline RefCountedSOA<Elements...>::RefCountedSOA()
+    inline RefCountedSOA<Elements...>::RefCountedSOA() :
+        _id(_storage.acquire())
     {
-        if (_available.size() > 0)
-        {
-            _id = _available.back();
-            _available.pop_back();
-        }
-        else
-        {
-            _id = static_cast<refid_t>(_soa.size());
-            _soa.resize(_soa.size()+1);
-        }
-
-        _soa.template get<_refCount>(_id) = 1;
     }
 
     template <typename... Elements>
     inline RefCountedSOA<Elements...>::RefCountedSOA(const RefCountedSOA &other) :
         _id(other._id)
     {
-        ++_soa.template get<_refCount>(_id);
+        _storage.retain(_id);
     }
 
     template <typename... Elements>
     inline RefCountedSOA<Elements...>::RefCountedSOA(RefCountedSOA &&other) :
         _id(std::move(other._id))
     {
-        ++_soa.template get<_refCount>(_id);
+        _storage.retain(_id);
     }
 
     template <typename... Elements>
     inline RefCountedSOA<Elements...>::~RefCountedSOA()
     {
-        if (--_soa.template get<_refCount>(_id) == 0)
-        {
-            _available.push_back(_id);
-        }
+        _storage.release(_id);
     }
 
     template <typename... Elements>
@@ -70,14 +56,11 @@ namespace tunis
     {
         if (this != &other)
         {
-            if (--_soa.template get<_refCount>(_id) == 0)
-            {
-                _available.push_back(_id);
-            }
+            // retain first, in case both share the same slot.
+            _storage.retain(other._id);
+            _storage.release(_id);
 
             _id = other._id;
-
-            ++_soa.template get<_refCount>(_id);
         }
 
         return *this;
@@ -88,14 +71,10 @@ namespace tunis
     {
         if (this != &other)
         {
-            if (--_soa.template get<_refCount>(_id) == 0)
-            {
-                _available.push_back(_id);
-            }
+            _storage.retain(other._id);
+            _storage.release(_id);
 
             _id = std::move(other._id);
-
-            ++_soa.template get<_refCount>(_id);
         }
 
         return *this;
@@ -119,18 +98,19 @@ namespace tunis
         return _id;
     }
 
+    template <typename... Elements>
+    typename RefCountedSOA<Elements...>::refcount_t RefCountedSOA<Elements...>::getRefCount() const
+    {
+        return _storage.refCount(_id);
+    }
+
     template <typename... Elements>
     template <typename T>
     inline T RefCountedSOA<Elements...>::clone()
     {
         T instance;
 
-        _soa.copy(_id, instance._id);
-
-        // since SoA::copy copies every fields cluding the refCount fields of the
-        // current instance, we need to manually reset our new instance's refcount
-        // field since there are no way to tell SoA::copy to exclude fields.
-        _soa.template get<_refCount>(instance._id) = 1;
+        _storage.copy(_id, instance._id);
 
         return std::move(instance);
     }
@@ -139,21 +119,18 @@ namespace tunis
     template <size_t ArrayIndex>
     inline typename SoA<Elements..., typename RefCountedSOA<Elements...>::refcount_t>::template NthTypeOf<ArrayIndex>& RefCountedSOA<Elements...>::get() const
     {
-        return _soa.template get<ArrayIndex>(_id);
+        return _storage.template get<ArrayIndex>(_id);
     }
 
 
     template <typename... Elements>
     inline void RefCountedSOA<Elements...>::reserve(size_t size)
     {
-        _soa.reserve(size);
+        _storage.reserve(size);
     }
 
     template <typename... Elements>
-    SoA<Elements..., typename RefCountedSOA<Elements...>::refcount_t> RefCountedSOA<Elements...>::_soa;
-
-    template <typename... Elements>
-    std::vector<typename RefCountedSOA<Elements...>::refid_t> RefCountedSOA<Elements...>::_available;
+    typename RefCountedSOA<Elements...>::Storage RefCountedSOA<Elements...>::_storage;
 
 
 }
@@ -0,0 +1,152 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISSOASTORAGE_H
+#define TUNISSOASTORAGE_H
+
+#include <soa.h>
+
+#include <cinttypes>
+#include <vector>
+
+#if defined(TUNIS_THREAD_SAFE_SOA)
+#include <TunisSpinLock.h>
+#include <concurrentqueue.h>
+#include <array>
+#include <atomic>
+#endif
+
+namespace tunis
+{
+    namespace detail
+    {
+        using refid_t = uint32_t;
+        using refcount_t = uint32_t;
+
+        /*!
+         * \brief SOAStorage is the default storage policy of RefCountedSOA: a
+         * single SoA grown on demand, holding the reference counts in its last
+         * array, and a vector of released slots.
+         *
+         * This is the fastest policy, but instances must only be created,
+         * copied and destroyed from one thread at a time, and growing the SoA
+         * invalidates every reference previously returned by get().
+         */
+        template <typename... Elements>
+        class SOAStorage
+        {
+        public:
+            using Array = SoA<Elements..., refcount_t>;
+
+            refid_t acquire();
+            void retain(refid_t id);
+            void release(refid_t id);
+            refcount_t refCount(refid_t id);
+            void copy(refid_t src, refid_t dst);
+            void reserve(size_t size);
+
+            template <size_t ArrayIndex>
+            typename Array::template NthTypeOf<ArrayIndex> &get(refid_t id);
+
+        private:
+            enum {_refCount = sizeof...(Elements) };
+
+            Array _soa;
+            std::vector<refid_t> _available;
+        };
+
+#if defined(TUNIS_THREAD_SAFE_SOA)
+
+        /*!
+         * \brief ConcurrentSOAStorage is the thread-safe storage policy of
+         * RefCountedSOA, selected by defining TUNIS_THREAD_SAFE_SOA.
+         *
+         * Slots are allocated in chunks that never move once created, so the
+         * references returned by get() remain valid while other threads grow
+         * the storage. Reference counts are atomic. Released slots go to a
+         * free list local to the releasing thread, and are handed over in bulk
+         * to a lock-free global queue once that list grows too long, or when
+         * the thread exits.
+         *
+         * As with any object, a single instance must not be modified from
+         * several threads at once.
+         */
+        template <typename... Elements>
+        class ConcurrentSOAStorage
+        {
+        public:
+            using Array = SoA<Elements..., refcount_t>;
+
+            ~ConcurrentSOAStorage();
+
+            refid_t acquire();
+            void retain(refid_t id);
+            void release(refid_t id);
+            refcount_t refCount(refid_t id);
+            void copy(refid_t src, refid_t dst);
+            void reserve(size_t size);
+
+            template <size_t ArrayIndex>
+            typename Array::template NthTypeOf<ArrayIndex> &get(refid_t id);
+
+        private:
+            enum
+            {
+                ChunkShift = 8,
+                ChunkSize = 1 << ChunkShift,
+                MaxChunkCount = 4096,
+                MaxLocalFreeCount = 2 * ChunkSize,
+            };
+
+            struct Chunk
+            {
+                SoA<Elements...> soa;
+                std::array<std::atomic<refcount_t>, ChunkSize> refCounts;
+            };
+
+            struct LocalFreeList
+            {
+                ConcurrentSOAStorage *storage = nullptr;
+                std::vector<refid_t> ids;
+                ~LocalFreeList();
+            };
+
+            LocalFreeList &localFreeList();
+            Chunk *chunk(refid_t id) const;
+            void grow(LocalFreeList &local);
+
+            // zero-initialized as a static, without needing a constructor.
+            std::atomic<Chunk*> _chunks[MaxChunkCount];
+            std::atomic<uint32_t> _chunkCount;
+            SpinLock _growLock;
+            moodycamel::ConcurrentQueue<refid_t> _available;
+        };
+
+#endif // TUNIS_THREAD_SAFE_SOA
+
+    }
+}
+
+#include <TunisSOAStorage.inl>
+
+#endif // TUNISSOASTORAGE_H
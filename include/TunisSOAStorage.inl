@@ -0,0 +1,268 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisSOAStorage.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace tunis
+{
+    namespace detail
+    {
+        template <typename... Elements>
+        inline refid_t SOAStorage<Elements...>::acquire()
+        {
+            refid_t id;
+
+            if (_available.size() > 0)
+            {
+                id = _available.back();
+                _available.pop_back();
+            }
+            else
+            {
+                id = static_cast<refid_t>(_soa.size());
+                _soa.resize(_soa.size()+1);
+            }
+
+            _soa.template get<_refCount>(id) = 1;
+
+            return id;
+        }
+
+        template <typename... Elements>
+        inline void SOAStorage<Elements...>::retain(refid_t id)
+        {
+            ++_soa.template get<_refCount>(id);
+        }
+
+        template <typename... Elements>
+        inline void SOAStorage<Elements...>::release(refid_t id)
+        {
+            if (--_soa.template get<_refCount>(id) == 0)
+            {
+                _available.push_back(id);
+            }
+        }
+
+        template <typename... Elements>
+        inline refcount_t SOAStorage<Elements...>::refCount(refid_t id)
+        {
+            return _soa.template get<_refCount>(id);
+        }
+
+        template <typename... Elements>
+        inline void SOAStorage<Elements...>::copy(refid_t src, refid_t dst)
+        {
+            _soa.copy(src, dst);
+
+            // since SoA::copy copies every fields cluding the refCount fields of the
+            // source, we need to manually reset the destination's refcount field
+            // since there are no way to tell SoA::copy to exclude fields.
+            _soa.template get<_refCount>(dst) = 1;
+        }
+
+        template <typename... Elements>
+        inline void SOAStorage<Elements...>::reserve(size_t size)
+        {
+            _soa.reserve(size);
+        }
+
+        template <typename... Elements>
+        template <size_t ArrayIndex>
+        inline typename SOAStorage<Elements...>::Array::template NthTypeOf<ArrayIndex> &SOAStorage<Elements...>::get(refid_t id)
+        {
+            return _soa.template get<ArrayIndex>(id);
+        }
+
+#if defined(TUNIS_THREAD_SAFE_SOA)
+
+        /*!
+         * copies the first FieldCount fields of a slot into another, which may
+         * live in a different chunk.
+         */
+        template <size_t FieldCount>
+        struct FieldCopy
+        {
+            template <typename Storage>
+            static inline void copy(Storage &storage, refid_t src, refid_t dst)
+            {
+                storage.template get<FieldCount-1>(dst) = storage.template get<FieldCount-1>(src);
+                FieldCopy<FieldCount-1>::copy(storage, src, dst);
+            }
+        };
+
+        template <>
+        struct FieldCopy<0>
+        {
+            template <typename Storage>
+            static inline void copy(Storage &, refid_t, refid_t) {}
+        };
+
+        template <typename... Elements>
+        inline ConcurrentSOAStorage<Elements...>::~ConcurrentSOAStorage()
+        {
+            for (uint32_t i = 0; i < _chunkCount.load(); ++i)
+            {
+                delete _chunks[i].load();
+            }
+        }
+
+        template <typename... Elements>
+        inline ConcurrentSOAStorage<Elements...>::LocalFreeList::~LocalFreeList()
+        {
+            // give our slots back to the other threads.
+            if (storage && ids.size() > 0)
+            {
+                storage->_available.enqueue_bulk(ids.data(), ids.size());
+            }
+        }
+
+        template <typename... Elements>
+        inline typename ConcurrentSOAStorage<Elements...>::LocalFreeList &ConcurrentSOAStorage<Elements...>::localFreeList()
+        {
+            // there is a single storage per RefCountedSOA type.
+            static thread_local LocalFreeList local;
+            local.storage = this;
+            return local;
+        }
+
+        template <typename... Elements>
+        inline typename ConcurrentSOAStorage<Elements...>::Chunk *ConcurrentSOAStorage<Elements...>::chunk(refid_t id) const
+        {
+            return _chunks[id >> ChunkShift].load(std::memory_order_acquire);
+        }
+
+        template <typename... Elements>
+        inline void ConcurrentSOAStorage<Elements...>::grow(LocalFreeList &local)
+        {
+            _growLock.lock();
+
+            uint32_t chunkId = _chunkCount.load(std::memory_order_relaxed);
+            if (chunkId == MaxChunkCount)
+            {
+                fprintf(stderr, "RefCountedSOA exceeded %u instances.\n", MaxChunkCount * ChunkSize);
+                abort();
+            }
+
+            Chunk *newChunk = new Chunk();
+            newChunk->soa.resize(ChunkSize);
+
+            _chunks[chunkId].store(newChunk, std::memory_order_release);
+            _chunkCount.store(chunkId + 1, std::memory_order_release);
+
+            _growLock.unlock();
+
+            // the new slots belong to this thread until they get released.
+            // Push them in reverse so they get acquired in order.
+            refid_t first = chunkId << ChunkShift;
+            for (refid_t id = first + ChunkSize; id > first; --id)
+            {
+                local.ids.push_back(id - 1);
+            }
+        }
+
+        template <typename... Elements>
+        inline refid_t ConcurrentSOAStorage<Elements...>::acquire()
+        {
+            LocalFreeList &local = localFreeList();
+
+            if (local.ids.size() == 0)
+            {
+                refid_t ids[ChunkSize];
+                size_t count = _available.try_dequeue_bulk(ids, ChunkSize);
+                local.ids.insert(local.ids.end(), ids, ids + count);
+            }
+
+            if (local.ids.size() == 0)
+            {
+                grow(local);
+            }
+
+            refid_t id = local.ids.back();
+            local.ids.pop_back();
+
+            chunk(id)->refCounts[id & (ChunkSize-1)].store(1, std::memory_order_relaxed);
+
+            return id;
+        }
+
+        template <typename... Elements>
+        inline void ConcurrentSOAStorage<Elements...>::retain(refid_t id)
+        {
+            chunk(id)->refCounts[id & (ChunkSize-1)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        template <typename... Elements>
+        inline void ConcurrentSOAStorage<Elements...>::release(refid_t id)
+        {
+            if (chunk(id)->refCounts[id & (ChunkSize-1)].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                LocalFreeList &local = localFreeList();
+                local.ids.push_back(id);
+
+                if (local.ids.size() > MaxLocalFreeCount)
+                {
+                    // keep half, and hand the other half over to the other
+                    // threads.
+                    size_t keep = local.ids.size() / 2;
+                    _available.enqueue_bulk(local.ids.data() + keep, local.ids.size() - keep);
+                    local.ids.resize(keep);
+                }
+            }
+        }
+
+        template <typename... Elements>
+        inline refcount_t ConcurrentSOAStorage<Elements...>::refCount(refid_t id)
+        {
+            return chunk(id)->refCounts[id & (ChunkSize-1)].load(std::memory_order_acquire);
+        }
+
+        template <typename... Elements>
+        inline void ConcurrentSOAStorage<Elements...>::copy(refid_t src, refid_t dst)
+        {
+            FieldCopy<sizeof...(Elements)>::copy(*this, src, dst);
+        }
+
+        template <typename... Elements>
+        inline void ConcurrentSOAStorage<Elements...>::reserve(size_t size)
+        {
+            LocalFreeList &local = localFreeList();
+            while (static_cast<size_t>(_chunkCount.load(std::memory_order_acquire)) * ChunkSize < size)
+            {
+                grow(local);
+            }
+        }
+
+        template <typename... Elements>
+        template <size_t ArrayIndex>
+        inline typename ConcurrentSOAStorage<Elements...>::Array::template NthTypeOf<ArrayIndex> &ConcurrentSOAStorage<Elements...>::get(refid_t id)
+        {
+            return chunk(id)->soa.template get<ArrayIndex>(id & (ChunkSize-1));
+        }
+
+#endif // TUNIS_THREAD_SAFE_SOA
+
+    }
+}
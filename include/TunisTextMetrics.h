@@ -0,0 +1,48 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISTEXTMETRICS_H
+#define TUNISTEXTMETRICS_H
+
+namespace tunis
+{
+
+/*!
+ * \brief TextMetrics holds the dimensions of a piece of text, as returned by
+ * Context::measureText(). The distances are in pixels, from the point the
+ * text would be drawn at with the current textAlign and textBaseline.
+ */
+struct TextMetrics
+{
+    float width = 0.0f;                    //!< advance width of the text, after kerning.
+    float actualBoundingBoxLeft = 0.0f;    //!< from the alignment point to the left of the glyphs, positive to the left.
+    float actualBoundingBoxRight = 0.0f;   //!< from the alignment point to the right of the glyphs.
+    float actualBoundingBoxAscent = 0.0f;  //!< from the baseline to the top of the glyphs, positive upwards.
+    float actualBoundingBoxDescent = 0.0f; //!< from the baseline to the bottom of the glyphs, positive downwards.
+    float fontBoundingBoxAscent = 0.0f;    //!< from the baseline to the ascender of the font, positive upwards.
+    float fontBoundingBoxDescent = 0.0f;   //!< from the baseline to the descender of the font, positive downwards.
+};
+
+}
+
+#endif // TUNISTEXTMETRICS_H
@@ -56,6 +56,12 @@ enum class FillRule : uint8_t
     evenodd, //! The even-odd winding rule.
 };
 
+enum class FillMode : uint8_t
+{
+    triangulate = 0, //! Fills are triangulated on the CPU. This is the default mode. The fill rule is ignored, and self-intersecting paths are not supported.
+    stencilThenCover, //! Fills write their winding into the stencil buffer, then cover their bounds where it is set. Honors the fill rule, and only costs O(n) on the CPU.
+};
+
 enum class CompositeOp : uint8_t
 {
     source_over = 0, //! This is the default setting and draws new shapes on top of the existing window content.
@@ -32,9 +32,38 @@ namespace tunis
     namespace detail
     {
 
+        /*!
+         * \brief VertexGradient holds the position of a gradient vertex, the
+         * index of the first texel of its gradient in the gradient data
+         * texture, and its position in user space, before the current
+         * transform, where the gradient is defined.
+         */
         struct VertexGradient
         {
             glm::vec2 a_position;
+            float a_gradient;
+            glm::vec2 a_paintPosition;
+        };
+
+        /*!
+         * \brief VertexPosition holds a vertex of an instanced mesh, in path
+         * space: the instances provide everything else.
+         */
+        struct VertexPosition
+        {
+            glm::vec2 a_position;
+        };
+
+        /*!
+         * \brief VertexInstance holds the per-instance attributes of an
+         * instanced fill: the rows (a c e) and (b d f) of its transform, and
+         * its color. Its vertices are VertexPosition.
+         */
+        struct VertexInstance
+        {
+            glm::vec3 a_transform0;
+            glm::vec3 a_transform1;
+            glm::u8vec4 a_color;
         };
 
         struct VertexTexture
@@ -46,7 +75,27 @@ namespace tunis
             glm::u8vec4 a_color;
         };
 
+        /*!
+         * \brief VertexGlyph holds a corner of a glyph quad: its position, the
+         * matching texel of the glyph in the atlas, and how many pixels its
+         * distance range covers on screen. a_stroke is half the line width,
+         * in pixels, of stroked text, and 0 for filled text.
+         */
+        struct VertexGlyph
+        {
+            glm::vec2 a_position;
+            glm::u16vec2 a_texcoord;
+            glm::u8vec4 a_color;
+            float a_range;
+            float a_stroke;
+        };
+
+#if defined(TUNIS_INDEX_32BIT)
+        using Index = uint32_t;
+#else
+        // Batches are split every 65536 vertices.
         using Index = uint16_t;
+#endif
 
     }
 }
@@ -0,0 +1,85 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <cstdio>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "24_StreamingUploadBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int circleCount = 2500;
+    const int reportInterval = 120; // in frames
+
+    int frameCount = 0;
+    double uploadTime = 0;
+    size_t vertexCount = 0;
+    size_t drawCallCount = 0;
+}
+
+/*!
+ * Streams about 40k animated vertices per frame and reports the CPU time spent
+ * handing them over to GL. Configure with -DTUNIS_STREAMING_UPLOAD=OFF to get
+ * the numbers of the glBufferData path for comparison.
+ */
+void SampleApp::render(double frameTime)
+{
+    // counters of the previous frame.
+    const FrameStats &stats = ctx.frameStats();
+    uploadTime += stats.uploadTime;
+    vertexCount += stats.vertexCount;
+    drawCallCount += stats.drawCallCount;
+
+    if (++frameCount == reportInterval)
+    {
+        printf("upload: %.3f ms/frame, %zu vertices/frame, %zu draw calls/frame\n",
+               uploadTime / frameCount,
+               vertexCount / frameCount,
+               drawCallCount / frameCount);
+
+        frameCount = 0;
+        uploadTime = 0;
+        vertexCount = 0;
+        drawCallCount = 0;
+    }
+
+    float time = static_cast<float>(frameTime);
+
+    for (int i = 0; i < circleCount; ++i)
+    {
+        float angle = time * 0.5f + i * 0.1f;
+        float distance = 20.0f + (i % 280);
+        float x = 400 + Math.cos(angle) * distance;
+        float y = 300 + Math.sin(angle) * distance;
+
+        ctx.fillStyle = rgb((i * 7) % 256, (i * 13) % 256, (i * 29) % 256);
+        ctx.beginPath();
+        ctx.arc(x, y, 6, 0, Math.PI * 2);
+        ctx.fill();
+    }
+}
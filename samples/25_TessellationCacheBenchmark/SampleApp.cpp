@@ -0,0 +1,106 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <cstdio>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "25_TessellationCacheBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int columns = 40;
+    const int rows = 30;
+    const int reportInterval = 120; // in frames
+
+    int frameCount = 0;
+    double tessellationTime = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+}
+
+/*!
+ * Draws the same 2400 filled stars and stroked curves every frame. After the
+ * first frame, every draw should be a tessellation cache hit. Define
+ * TUNIS_TESSELLATION_CACHE_BUDGET=0 to get the numbers without the cache.
+ */
+void SampleApp::render(double)
+{
+    // counters of the previous frame.
+    const FrameStats &stats = ctx.frameStats();
+    tessellationTime += stats.tessellationTime;
+    hits += stats.tessellationCacheHits;
+    misses += stats.tessellationCacheMisses;
+
+    if (++frameCount == reportInterval)
+    {
+        printf("tessellation: %.3f ms/frame, %zu hits/frame, %zu misses/frame, %zu KiB cached\n",
+               tessellationTime / frameCount,
+               hits / frameCount,
+               misses / frameCount,
+               stats.tessellationCacheSize / 1024);
+
+        frameCount = 0;
+        tessellationTime = 0;
+        hits = 0;
+        misses = 0;
+    }
+
+    ctx.lineWidth = 2;
+
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            float x = 10 + column * 20.0f;
+            float y = 10 + row * 20.0f;
+
+            if ((row + column) % 2 == 0)
+            {
+                // five-pointed star
+                ctx.fillStyle = rgb((column * 6) % 256, (row * 8) % 256, 160);
+                ctx.beginPath();
+                for (int i = 0; i < 10; ++i)
+                {
+                    float angle = i * Math.PI / 5 - Math.PI / 2;
+                    float radius = (i % 2 == 0) ? 9.0f : 4.0f;
+                    ctx.lineTo(x + Math.cos(angle) * radius, y + Math.sin(angle) * radius);
+                }
+                ctx.closePath();
+                ctx.fill();
+            }
+            else
+            {
+                ctx.strokeStyle = rgb(160, (column * 6) % 256, (row * 8) % 256);
+                ctx.beginPath();
+                ctx.moveTo(x - 8, y + 6);
+                ctx.bezierCurveTo(x - 4, y - 10, x + 4, y + 10, x + 8, y - 6);
+                ctx.stroke();
+            }
+        }
+    }
+}
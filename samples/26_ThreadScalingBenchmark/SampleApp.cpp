@@ -0,0 +1,139 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "26_ThreadScalingBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int rectCount = 1000;
+    const int reportInterval = 120; // in frames
+
+    // runs every task on the calling thread.
+    class SerialExecutor : public Executor
+    {
+    public:
+        size_t concurrency() const override { return 1; }
+        void submit(Task task) override { task(); }
+    };
+
+    SerialExecutor serialExecutor;
+    std::unique_ptr<JobSystem> jobSystem;
+
+    size_t threadCount = 0;
+    int frameCount = 0;
+    double tessellationTime = 0;
+    double serialTessellationTime = 0;
+
+    void useThreadCount(Context &ctx, size_t count)
+    {
+        threadCount = count;
+        if (count == 1)
+        {
+            ctx.setExecutor(&serialExecutor);
+            jobSystem.reset();
+        }
+        else
+        {
+            // the thread calling endFrame() is one of them.
+            std::unique_ptr<JobSystem> newJobSystem(new JobSystem(count - 1));
+            ctx.setExecutor(newJobSystem.get());
+            jobSystem = std::move(newJobSystem);
+        }
+    }
+}
+
+/*!
+ * Re-tessellates a long dashed bezier stroke next to 1000 small rects every
+ * frame, with 1, 2, ... up to one thread per hardware thread, and reports the
+ * tessellation time and speedup of each thread count.
+ */
+void SampleApp::render(double frameTime)
+{
+    if (threadCount == 0)
+    {
+        useThreadCount(ctx, 1);
+    }
+    else
+    {
+        // counters of the previous frame.
+        tessellationTime += ctx.frameStats().tessellationTime;
+
+        if (++frameCount == reportInterval)
+        {
+            double average = tessellationTime / frameCount;
+            if (threadCount == 1)
+            {
+                serialTessellationTime = average;
+            }
+
+            printf("%zu thread(s): tessellation %.3f ms/frame, speedup x%.2f\n",
+                   threadCount, average, serialTessellationTime / average);
+
+            frameCount = 0;
+            tessellationTime = 0;
+
+            size_t maxThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+            useThreadCount(ctx, threadCount < maxThreadCount ? threadCount + 1 : 1);
+        }
+    }
+
+    float time = static_cast<float>(frameTime);
+
+    // a single expensive draw: the dash offset changes every frame, so it
+    // misses the tessellation cache.
+    ctx.lineWidth = 3;
+    ctx.lineJoin = LineJoin::round;
+    ctx.lineCap = LineCap::round;
+    ctx.setLineDash({4, 3});
+    ctx.lineDashOffset = time * 20.0f;
+    ctx.strokeStyle = rgb(0, 96, 160);
+    ctx.beginPath();
+    ctx.moveTo(20, 300);
+    for (int i = 0; i < 40; ++i)
+    {
+        float x = 20 + i * 19.0f;
+        ctx.bezierCurveTo(x + 5, 20, x + 14, 580, x + 19, 300);
+    }
+    ctx.stroke();
+    ctx.setLineDash({});
+
+    // many cheap draws, moving so they miss the cache too.
+    for (int i = 0; i < rectCount; ++i)
+    {
+        float x = 20 + (i % 50) * 15.0f + Math.sin(time + i) * 4.0f;
+        float y = 20 + (i / 50) * 28.0f;
+
+        ctx.fillStyle = rgb((i * 7) % 256, 128, (i * 13) % 256);
+        ctx.fillRect(x, y, 10, 10);
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// count the heap allocations made, on any thread, while the context
+// tessellates.
+static std::atomic<bool> tessellating(false);
+static std::atomic<size_t> allocationCount(0);
+
+void *operator new(size_t size)
+{
+    if (tessellating)
+    {
+        ++allocationCount;
+    }
+
+    if (void *ptr = malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "27_TessellationAllocations"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int shapeCount = 500;
+    const int warmUpFrames = 10; // for the arenas, meshes and queues to reach their size.
+    const int reportInterval = 120; // in frames
+
+    int frameCount = 0;
+    size_t misses = 0;
+}
+
+/*!
+ * Tessellates the same 500 stars and dashed strokes again every frame, with the
+ * tessellation cache disabled, and counts the heap allocations made while the
+ * context tessellates. Once warmed up, contour generation, triangulation and
+ * the parallel for spreading them over the threads must not allocate at all:
+ * the sample exits with a failure as soon as a frame does.
+ */
+void SampleApp::render(double /*frameTime*/)
+{
+    if (frameCount == 0)
+    {
+        ctx.setTessellationCacheBudget(0);
+        ctx.setTessellationObserver([](bool begin) { tessellating = begin; });
+    }
+
+    // allocations made while the previous frame was tessellated.
+    size_t allocations = allocationCount.exchange(0);
+    misses += ctx.frameStats().tessellationCacheMisses;
+
+    if (++frameCount > warmUpFrames && allocations > 0)
+    {
+        fprintf(stderr, "FAILED: %zu allocations while tessellating %zu draws.\n",
+                allocations, ctx.frameStats().tessellationCacheMisses);
+        exit(EXIT_FAILURE);
+    }
+
+    if (frameCount % reportInterval == 0)
+    {
+        printf("0 allocations while tessellating, %.1f tessellation cache misses/frame\n",
+               static_cast<double>(misses) / reportInterval);
+        misses = 0;
+    }
+
+    ctx.lineWidth = 2;
+    ctx.setLineDash({6, 4});
+
+    for (int i = 0; i < shapeCount; ++i)
+    {
+        float x = 20 + (i % 25) * 31.0f;
+        float y = 20 + (i / 25) * 29.0f;
+        float spin = i * 0.1f;
+
+        ctx.beginPath();
+        for (int p = 0; p < 10; ++p)
+        {
+            float angle = spin + p * Math.PI / 5;
+            float radius = (p % 2 == 0) ? 12.0f : 5.0f;
+            ctx.lineTo(x + Math.cos(angle) * radius, y + Math.sin(angle) * radius);
+        }
+        ctx.closePath();
+
+        if (i % 2 == 0)
+        {
+            ctx.fillStyle = rgb((i * 7) % 256, 160, (i * 13) % 256);
+            ctx.fill();
+        }
+        else
+        {
+            ctx.strokeStyle = rgb(160, (i * 7) % 256, (i * 13) % 256);
+            ctx.stroke();
+        }
+    }
+
+    ctx.setLineDash({});
+}
@@ -0,0 +1,71 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <cstdio>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "28_RectFillBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int rectCount = 100000;
+    const int reportInterval = 60; // in frames
+
+    int frameCount = 0;
+    double tessellationTime = 0;
+}
+
+/*!
+ * Fills 100k moving rects per frame, so every one of them is tessellated again
+ * each frame, and reports the time spent tessellating them. Define
+ * TUNIS_CONVEX_FAST_PATH=0 when building Tunis to compare with poly2tri.
+ */
+void SampleApp::render(double frameTime)
+{
+    // counters of the previous frame.
+    tessellationTime += ctx.frameStats().tessellationTime;
+
+    if (++frameCount == reportInterval)
+    {
+        printf("tessellation: %.3f ms/frame for %d rects\n", tessellationTime / frameCount, rectCount);
+
+        frameCount = 0;
+        tessellationTime = 0;
+    }
+
+    float offset = static_cast<float>(frameTime) * 10.0f;
+
+    for (int i = 0; i < rectCount; ++i)
+    {
+        float x = (i % 400) * 2.0f;
+        float y = (i / 400) * 2.4f;
+
+        ctx.fillStyle = rgb((i * 7) % 256, (i * 13) % 256, 192);
+        ctx.fillRect(x + Math.sin(offset + i) * 2.0f, y, 3, 3);
+    }
+}
@@ -0,0 +1,143 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <cstdio>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "29_StencilFillBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int glyphCount = 400;
+    const int chartCount = 8;
+    const int chartPointCount = 2000;
+    const int reportInterval = 120; // in frames
+
+    int frameCount = 0;
+    double tessellationTime = 0;
+    double uploadTime = 0;
+    size_t drawCallCount = 0;
+
+    FillMode fillMode = FillMode::triangulate;
+
+    const char *fillModeName(FillMode mode)
+    {
+        return mode == FillMode::triangulate ? "triangulate" : "stencil-then-cover";
+    }
+
+    // an "o"-like glyph: a curved outer outline and its counter, wound the
+    // same way so only the even-odd rule punches the hole.
+    void glyph(Path2D &path, float x, float y, float size)
+    {
+        float r = size * 0.5f;
+        float k = r * 0.5523f; // cubic approximation of a quarter circle.
+
+        for (int i = 0; i < 2; ++i)
+        {
+            float rx = i == 0 ? r : r * 0.55f;
+            float ry = i == 0 ? r : r * 0.7f;
+            float kx = k * rx / r;
+            float ky = k * ry / r;
+
+            path.moveTo(x + rx, y);
+            path.bezierCurveTo(x + rx, y + ky, x + kx, y + ry, x, y + ry);
+            path.bezierCurveTo(x - kx, y + ry, x - rx, y + ky, x - rx, y);
+            path.bezierCurveTo(x - rx, y - ky, x - kx, y - ry, x, y - ry);
+            path.bezierCurveTo(x + kx, y - ry, x + rx, y - ky, x + rx, y);
+            path.closePath();
+        }
+    }
+
+    // an area chart: a long concave polyline closed along its baseline.
+    void chart(Path2D &path, float x, float y, float width, float height, float phase)
+    {
+        path.moveTo(x, y + height);
+        for (int i = 0; i < chartPointCount; ++i)
+        {
+            float t = static_cast<float>(i) / (chartPointCount - 1);
+            float v = 0.5f + 0.3f * Math.sin(t * 40.0f + phase) + 0.2f * Math.sin(t * 173.0f - phase * 3.0f);
+            path.lineTo(x + t * width, y + height * (1.0f - v));
+        }
+        path.lineTo(x + width, y + height);
+        path.closePath();
+    }
+}
+
+/*!
+ * Fills 400 moving glyph-like shapes and 8 area charts of 2000 points per
+ * frame, so every one of them is tessellated again each frame, switching
+ * between the triangulating and the stencil-then-cover fill modes every
+ * reportInterval frames. Reports the CPU time spent tessellating and
+ * uploading, and the draw calls, of each mode.
+ */
+void SampleApp::render(double frameTime)
+{
+    // counters of the previous frame.
+    const FrameStats &stats = ctx.frameStats();
+    tessellationTime += stats.tessellationTime;
+    uploadTime += stats.uploadTime;
+    drawCallCount += stats.drawCallCount;
+
+    if (++frameCount == reportInterval)
+    {
+        printf("%s: tessellation %.3f ms/frame, upload %.3f ms/frame, %zu draw calls/frame\n",
+               fillModeName(fillMode),
+               tessellationTime / frameCount,
+               uploadTime / frameCount,
+               drawCallCount / frameCount);
+
+        frameCount = 0;
+        tessellationTime = 0;
+        uploadTime = 0;
+        drawCallCount = 0;
+
+        fillMode = fillMode == FillMode::triangulate ? FillMode::stencilThenCover : FillMode::triangulate;
+    }
+
+    ctx.setFillMode(fillMode);
+
+    float offset = static_cast<float>(frameTime);
+
+    Path2D path;
+    for (int i = 0; i < glyphCount; ++i)
+    {
+        float x = 20.0f + (i % 25) * 31.0f + Math.sin(offset + i);
+        float y = 20.0f + (i / 25) * 18.0f;
+
+        glyph(path, x, y, 16.0f);
+        ctx.fillStyle = rgb((i * 7) % 256, (i * 13) % 256, 192);
+        ctx.fill(path, FillRule::evenodd);
+    }
+
+    for (int i = 0; i < chartCount; ++i)
+    {
+        chart(path, 20.0f + (i % 2) * 390.0f, 310.0f + (i / 2) * 70.0f, 370.0f, 60.0f, offset + i);
+        ctx.fillStyle = rgba(32 * i, 128, 255 - 32 * i, 0.8);
+        ctx.fill(path);
+    }
+}
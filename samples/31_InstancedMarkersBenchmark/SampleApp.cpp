@@ -0,0 +1,144 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "31_InstancedMarkersBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int markerCount = 20000;
+    const int reportInterval = 120; // in frames
+
+    int frameCount = 0;
+    double renderTime = 0;
+    double uploadTime = 0;
+    size_t vertexCount = 0;
+    size_t instanceCount = 0;
+    size_t drawCallCount = 0;
+
+    bool instanced = true;
+
+    std::vector<SVGMatrix> transforms(markerCount);
+    std::vector<Color> colors(markerCount);
+
+    // a five-pointed star marker centered on the origin.
+    void marker(Path2D &path)
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            float angle = Math.PI * i / 5.0f - Math.PI * 0.5f;
+            float radius = i % 2 == 0 ? 5.0f : 2.0f;
+            float x = radius * Math.cos(angle);
+            float y = radius * Math.sin(angle);
+            if (i == 0)
+            {
+                path.moveTo(x, y);
+            }
+            else
+            {
+                path.lineTo(x, y);
+            }
+        }
+        path.closePath();
+    }
+}
+
+/*!
+ * Draws 20000 moving star markers per frame, alternating every reportInterval
+ * frames between a single Context::fillInstances and one fill per marker, and
+ * reports the CPU time spent queuing them and what was streamed to GL.
+ */
+void SampleApp::render(double frameTime)
+{
+    // counters of the previous frame.
+    const FrameStats &stats = ctx.frameStats();
+    uploadTime += stats.uploadTime;
+    vertexCount += stats.vertexCount;
+    instanceCount += stats.instanceCount;
+    drawCallCount += stats.drawCallCount;
+
+    if (++frameCount == reportInterval)
+    {
+        printf("%s: render %.3f ms/frame, upload %.3f ms/frame, %zu vertices, %zu instances, %zu draw calls/frame\n",
+               instanced ? "fillInstances" : "fill",
+               renderTime / frameCount,
+               uploadTime / frameCount,
+               vertexCount / frameCount,
+               instanceCount / frameCount,
+               drawCallCount / frameCount);
+
+        frameCount = 0;
+        renderTime = 0;
+        uploadTime = 0;
+        vertexCount = 0;
+        instanceCount = 0;
+        drawCallCount = 0;
+
+        instanced = !instanced;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    float offset = static_cast<float>(frameTime);
+
+    for (int i = 0; i < markerCount; ++i)
+    {
+        float x = 5.0f + (i % 160) * 5.0f + Math.sin(offset + i) * 2.0f;
+        float y = 5.0f + (i / 160) * 4.8f;
+
+        transforms[i] = SVGMatrix(1.0f);
+        transforms[i][0].z = x;
+        transforms[i][1].z = y;
+        colors[i] = rgb((i * 7) % 256, (i * 13) % 256, 192);
+    }
+
+    Path2D path;
+    if (instanced)
+    {
+        marker(path);
+        ctx.fillInstances(path, transforms.data(), colors.data(), markerCount);
+    }
+    else
+    {
+        for (int i = 0; i < markerCount; ++i)
+        {
+            ctx.save();
+            ctx.translate(transforms[i][0].z, transforms[i][1].z);
+            ctx.fillStyle = colors[i];
+            marker(path);
+            ctx.fill(path);
+            ctx.restore();
+        }
+    }
+
+    renderTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
@@ -0,0 +1,97 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <cstdio>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "32_DrawReorderBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int columns = 40;
+    const int rows = 30;
+    const int reportInterval = 120; // in frames
+
+    int frameCount = 0;
+    size_t drawCallCount = 0;
+    size_t unsortedDrawCallCount = 0;
+}
+
+/*!
+ * Draws a grid of cells alternating between solid colors and a gradient, with
+ * a column of overlapping solid bars on top, and reports the draw calls issued
+ * with and without reordering. Define TUNIS_REORDER_WINDOW=0 when building
+ * Tunis to batch the draws in submission order.
+ */
+void SampleApp::render(double)
+{
+    // counters of the previous frame.
+    const FrameStats &stats = ctx.frameStats();
+    drawCallCount += stats.drawCallCount;
+    unsortedDrawCallCount += stats.unsortedDrawCallCount;
+
+    if (++frameCount == reportInterval)
+    {
+        printf("draw calls: %zu/frame reordered, %zu/frame in submission order\n",
+               drawCallCount / frameCount,
+               unsortedDrawCallCount / frameCount);
+
+        frameCount = 0;
+        drawCallCount = 0;
+        unsortedDrawCallCount = 0;
+    }
+
+    // share the same paint, so the gradient cells can share their batches.
+    auto lingrad = ctx.createLinearGradient(0, 0, 0, 600);
+    lingrad.addColorStop(0, "#00ABEB");
+    lingrad.addColorStop(1, "#26C000");
+    Paint gradient = lingrad;
+
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            if ((row + column) % 2 == 0)
+            {
+                ctx.fillStyle = rgb(column * 6, row * 8, 128);
+            }
+            else
+            {
+                ctx.fillStyle = gradient;
+            }
+            ctx.fillRect(column * 20.0f + 1, row * 20.0f + 1, 18, 18);
+        }
+    }
+
+    // these overlap the cells, so they must stay on top of them.
+    ctx.fillStyle = rgba(0, 0, 0, 0.5);
+    for (int row = 0; row < rows; ++row)
+    {
+        ctx.fillRect(390, row * 20.0f + 5, 20, 10);
+    }
+}
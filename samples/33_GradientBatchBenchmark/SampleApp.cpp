@@ -0,0 +1,95 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <cstdio>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "33_GradientBatchBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int columns = 20;
+    const int rows = 15;
+    const int colorStopCount = 6;
+    const int reportInterval = 120; // in frames
+
+    int frameCount = 0;
+    size_t drawCallCount = 0;
+    size_t vertexCount = 0;
+}
+
+/*!
+ * Draws a grid of cells, each filled with its own linear or radial gradient
+ * of six color stops, and reports the draw calls it took. Every linear cell
+ * shares one batch, and every radial cell another.
+ */
+void SampleApp::render(double t)
+{
+    // counters of the previous frame.
+    const FrameStats &stats = ctx.frameStats();
+    drawCallCount += stats.drawCallCount;
+    vertexCount += stats.vertexCount;
+
+    if (++frameCount == reportInterval)
+    {
+        printf("%d gradients: %zu draw calls/frame, %zu vertices/frame\n",
+               columns * rows,
+               drawCallCount / frameCount,
+               vertexCount / frameCount);
+
+        frameCount = 0;
+        drawCallCount = 0;
+        vertexCount = 0;
+    }
+
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            float x = column * 40.0f;
+            float y = row * 40.0f;
+            float phase = static_cast<float>(t) + (row * columns + column) * 0.1f;
+
+            Gradient gradient = (row + column) % 2 == 0 ?
+                        ctx.createLinearGradient(x, y, x + 40, y + 40) :
+                        ctx.createRadialGradient(x + 20, y + 20, 0, x + 20, y + 20, 20);
+
+            for (int i = 0; i < colorStopCount; ++i)
+            {
+                float a = phase + i * Math.PI / colorStopCount;
+                gradient.addColorStop(static_cast<float>(i) / (colorStopCount - 1),
+                                      rgb(static_cast<int>(127.5f + 127.5f * Math.sin(a)),
+                                          static_cast<int>(127.5f + 127.5f * Math.cos(a)),
+                                          (column * 255) / columns));
+            }
+
+            ctx.fillStyle = gradient;
+            ctx.fillRect(x + 1, y + 1, 38, 38);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <TunisAtlasAllocator.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "34_AtlasPackingBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int iconCount = 5000;
+    const int pageSize = 2048;
+    const int reportInterval = 120; // in frames
+
+    struct Icon
+    {
+        int32_t width, height;
+        int32_t x, y;
+        size_t page;
+    };
+
+    int frameCount = 0;
+    double packTime = 0.0;
+    double repackTime = 0.0;
+    size_t pageCount = 0;
+    float fragmentation = 0.0f;
+
+    // 16 to 128 pixels, mostly small ones, like a stream of icons and glyphs.
+    int32_t randomSize()
+    {
+        int32_t size = 16 + rand() % 48;
+        return rand() % 8 == 0 ? size * 2 : size;
+    }
+
+    void place(std::vector<std::unique_ptr<tunis::detail::AtlasAllocator>> &pages, Icon &icon)
+    {
+        for (icon.page = 0; icon.page < pages.size(); ++icon.page)
+        {
+            if (pages[icon.page]->allocate(icon.width, icon.height, icon.x, icon.y))
+            {
+                return;
+            }
+        }
+
+        pages.emplace_back(new tunis::detail::AtlasAllocator(pageSize, pageSize));
+        pages.back()->allocate(icon.width, icon.height, icon.x, icon.y);
+    }
+}
+
+/*!
+ * Packs 5000 icons of mixed sizes into as many 2048x2048 atlas pages as they
+ * need, then frees every other one and packs as many new ones, and reports how
+ * long both took and how fragmented the pages ended up. Nothing is drawn.
+ */
+void SampleApp::render(double)
+{
+    std::vector<std::unique_ptr<tunis::detail::AtlasAllocator>> pages;
+    std::vector<Icon> icons(iconCount);
+
+    srand(static_cast<unsigned>(frameCount));
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (Icon &icon : icons)
+    {
+        icon.width = randomSize();
+        icon.height = randomSize();
+        place(pages, icon);
+    }
+    auto packed = std::chrono::high_resolution_clock::now();
+
+    for (size_t i = 0; i < icons.size(); i += 2)
+    {
+        Icon &icon = icons[i];
+        pages[icon.page]->deallocate(icon.x, icon.y, icon.width);
+
+        icon.width = randomSize();
+        icon.height = randomSize();
+        place(pages, icon);
+    }
+    auto repacked = std::chrono::high_resolution_clock::now();
+
+    packTime += std::chrono::duration<double, std::milli>(packed - start).count();
+    repackTime += std::chrono::duration<double, std::milli>(repacked - packed).count();
+    pageCount += pages.size();
+    for (auto &page : pages)
+    {
+        fragmentation += page->fragmentation() / pages.size();
+    }
+
+    if (++frameCount == reportInterval)
+    {
+        printf("%d icons: packed in %.3f ms, half repacked in %.3f ms, %.1f pages, %.0f%% fragmentation\n",
+               iconCount,
+               packTime / frameCount,
+               repackTime / frameCount,
+               static_cast<double>(pageCount) / frameCount,
+               100.0 * fragmentation / frameCount);
+
+        frameCount = 0;
+        packTime = 0.0;
+        repackTime = 0.0;
+        pageCount = 0;
+        fragmentation = 0.0f;
+    }
+}
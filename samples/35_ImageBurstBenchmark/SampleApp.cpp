@@ -0,0 +1,107 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "35_ImageBurstBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int imageCount = 200;
+    const int columns = 20;
+    const int burstInterval = 240; // in frames
+
+    int frameCount = 0;
+    std::vector<Image> images;
+    std::vector<double> frameTimes;
+    std::chrono::high_resolution_clock::time_point lastFrame;
+    size_t uploadBytes = 0;
+}
+
+/*!
+ * Loads a burst of 200 images every 240 frames and draws each of them in its
+ * own cell, then reports the median and 99th percentile frame times of the
+ * frames that followed the burst, and how many frames the uploads were spread
+ * over. Build with TUNIS_UPLOAD_BUDGET=0 to compare with uploading every image
+ * in the frame it is decoded.
+ */
+void SampleApp::render(double)
+{
+    auto now = std::chrono::high_resolution_clock::now();
+    if (frameCount > 0)
+    {
+        frameTimes.push_back(std::chrono::duration<double, std::milli>(now - lastFrame).count());
+    }
+    lastFrame = now;
+
+    // counters of the previous frame.
+    const FrameStats &stats = ctx.frameStats();
+    uploadBytes += stats.imageUploadBytes;
+
+    if (frameCount == burstInterval)
+    {
+        std::sort(frameTimes.begin(), frameTimes.end());
+        printf("%d images: %.1f MB uploaded, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+               imageCount,
+               uploadBytes / (1024.0 * 1024.0),
+               frameTimes[frameTimes.size() / 2],
+               frameTimes[(frameTimes.size() * 99) / 100],
+               frameTimes.back());
+
+        frameCount = 0;
+        frameTimes.resize(0);
+        uploadBytes = 0;
+    }
+
+    if (frameCount == 0)
+    {
+        // the previous ones are dropped, and freed from the atlas. The new
+        // ones are decoded in place, so they must never be moved.
+        images.resize(0);
+        images.reserve(imageCount);
+        for (int i = 0; i < imageCount; ++i)
+        {
+            images.emplace_back("Canvas_createpattern.png");
+        }
+    }
+    ++frameCount;
+
+    float size = static_cast<float>(getWindowWidth()) / columns;
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        float x = (i % columns) * size;
+        float y = (i / columns) * size;
+
+        ctx.fillStyle = ctx.createPattern(images[i], RepeatType::no_repeat);
+        ctx.fillRect(x, y, size, size);
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#include <cstdio>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "36_TextBatchBenchmark"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int lines = 38;
+    const int reportInterval = 120; // in frames
+
+    int frameCount = 0;
+    size_t drawCallCount = 0;
+    size_t vertexCount = 0;
+    size_t layoutHits = 0;
+    size_t layoutMisses = 0;
+}
+
+/*!
+ * Fills the window with lines of text, every other one stroked, and reports
+ * the draw calls it took. Every glyph is a quad of the same atlas page, so
+ * the whole screen should take a couple of draw calls. The same lines are
+ * drawn every frame, so after the first one their layout is cached, and the
+ * title is centered with measureText() without laying it out again.
+ */
+void SampleApp::render(double t)
+{
+    // counters of the previous frame.
+    const FrameStats &stats = ctx.frameStats();
+    drawCallCount += stats.drawCallCount;
+    vertexCount += stats.vertexCount;
+    layoutHits += stats.textLayoutCacheHits;
+    layoutMisses += stats.textLayoutCacheMisses;
+
+    if (++frameCount == reportInterval)
+    {
+        printf("%d lines: %zu draw calls/frame, %zu vertices/frame, %.1f%% layout cache hits\n",
+               lines,
+               drawCallCount / frameCount,
+               vertexCount / frameCount,
+               100.0 * layoutHits / (layoutHits + layoutMisses > 0 ? layoutHits + layoutMisses : 1));
+
+        frameCount = 0;
+        drawCallCount = 0;
+        vertexCount = 0;
+        layoutHits = 0;
+        layoutMisses = 0;
+    }
+
+    const char *title = "Text batch benchmark";
+    ctx.font = "20px Roboto";
+    ctx.fillStyle = "Black";
+    ctx.textBaseline = TextBaseline::top;
+    TextMetrics metrics = ctx.measureText(title);
+    ctx.fillText(title, (getWindowWidth() - metrics.width) * 0.5f, 2);
+
+    ctx.font = "14px Roboto";
+    ctx.strokeStyle = "DarkBlue";
+    ctx.lineWidth = 1;
+
+    for (int line = 0; line < lines; ++line)
+    {
+        float x = 5.0f + 5.0f * Math.sin(static_cast<float>(t) + line * 0.2f);
+        float y = 30.0f + line * 15.0f;
+
+        if (line % 2 == 0)
+        {
+            ctx.fillText("The quick brown fox jumps over the lazy dog. 0123456789 !?", x, y);
+        }
+        else
+        {
+            ctx.strokeText("THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG. 0123456789 !?", x, y);
+        }
+    }
+}
@@ -0,0 +1,164 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2026 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+#include "SampleApp.h"
+
+#if !defined(TUNIS_THREAD_SAFE_SOA)
+#error "37_ThreadSafeSOAStress must be built with -DTUNIS_THREAD_SAFE_SOA=ON"
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+std::unique_ptr<SampleApp> SampleApp::create() { return std::unique_ptr<SampleApp>(new SampleApp()); }
+const char *SampleApp::getSampleName() { return "37_ThreadSafeSOAStress"; }
+int SampleApp::getWindowWidth() { return 800; }
+int SampleApp::getWindowHeight() { return 600; }
+
+namespace
+{
+    const int threadCount = 4;
+    const int iterationCount = 2000; // per thread and per frame
+    const int batchSize = 64; // handles kept alive before a batch is released
+    const int reportInterval = 120; // in frames
+
+    int frameCount = 0;
+
+    // what a worker still holds when it exits, released by the render thread.
+    struct Batch
+    {
+        std::vector<Paint> paints;
+        std::vector<Path2D> paths;
+        std::vector<Image> images;
+    };
+
+    void work(int thread, const Paint &shared, Batch &batch)
+    {
+        for (int i = 0; i < iterationCount; ++i)
+        {
+            if (i % batchSize == 0)
+            {
+                batch.paints.clear();
+                batch.paths.clear();
+                batch.images.clear();
+            }
+
+            Image image;
+            batch.images.push_back(image);
+
+            batch.paints.push_back(shared);
+            batch.paints.push_back(Paint(rgb((thread * 60) % 256, (i * 7) % 256, 128)));
+
+            Path2D path;
+            path.rect(20 + thread * 190.0f, 20 + (i % batchSize) * 8.0f, 180, 6);
+            batch.paths.push_back(path);
+        }
+    }
+
+    template <typename T>
+    bool unique(const std::vector<Batch> &batches, std::vector<T> Batch::*handles)
+    {
+        std::vector<typename T::refid_t> ids;
+        for (const Batch &batch : batches)
+        {
+            for (const T &handle : batch.*handles)
+            {
+                ids.push_back(handle.getId());
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        return std::adjacent_find(ids.begin(), ids.end()) == ids.end();
+    }
+
+    void fail(const char *reason)
+    {
+        fprintf(stderr, "FAILED: %s\n", reason);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*!
+ * Creates, copies and releases Paint, Path2D and Image handles from 4 threads
+ * every frame, under TUNIS_THREAD_SAFE_SOA. The threads exit at the end of the
+ * frame, flushing their free lists, and what they still hold is released by
+ * the render thread after drawing it. The sample exits with a failure if two
+ * live handles share a slot or if the reference count of the paint shared by
+ * every thread is off once they are done.
+ */
+void SampleApp::render(double /*frameTime*/)
+{
+    Paint shared(rgb(255, 165, 0));
+    std::vector<Batch> batches(threadCount);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back(work, t, std::cref(shared), std::ref(batches[t]));
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    if (!unique(batches, &Batch::paints) ||
+        !unique(batches, &Batch::paths) ||
+        !unique(batches, &Batch::images))
+    {
+        fail("two live handles share the same slot.");
+    }
+
+    size_t expected = 1;
+    for (const Batch &batch : batches)
+    {
+        expected += batch.paints.size() / 2;
+    }
+    if (shared.getRefCount() != expected)
+    {
+        fail("the reference count of the shared paint is off.");
+    }
+
+    for (Batch &batch : batches)
+    {
+        for (size_t i = 0; i < batch.paths.size(); ++i)
+        {
+            ctx.fillStyle = batch.paints[i * 2 + 1];
+            ctx.fill(batch.paths[i]);
+        }
+    }
+
+    batches.clear();
+    if (shared.getRefCount() != 1)
+    {
+        fail("the shared paint is still referenced after its copies were released.");
+    }
+
+    if (++frameCount % reportInterval == 0)
+    {
+        printf("%d frames, %d handles created per frame on %d threads\n",
+               frameCount, iterationCount * threadCount * 4, threadCount);
+    }
+}
@@ -38,16 +38,58 @@
 #endif
 
 #ifndef TUNIS_VERTEX_MAX
-#define TUNIS_VERTEX_MAX 16384
+#define TUNIS_VERTEX_MAX 65536
+#endif
+
+#ifndef TUNIS_CONVEX_FAST_PATH
+#define TUNIS_CONVEX_FAST_PATH 1 // set to 0 to triangulate every fill with poly2tri.
+#endif
+
+#ifndef TUNIS_THREAD_COUNT
+#define TUNIS_THREAD_COUNT 0 // one worker per hardware thread but one.
+#endif
+
+#ifndef TUNIS_TESSELLATION_CACHE_BUDGET
+#define TUNIS_TESSELLATION_CACHE_BUDGET (32*1024*1024)
+#endif
+
+#ifndef TUNIS_ATLAS_BUDGET
+#define TUNIS_ATLAS_BUDGET (64*1024*1024) // bytes of texture memory for the atlas pages.
+#endif
+
+#ifndef TUNIS_UPLOAD_BUDGET
+#define TUNIS_UPLOAD_BUDGET (4*1024*1024) // bytes of image pixels uploaded per frame, 0 to upload them all right away.
+#endif
+
+#ifndef TUNIS_FONT_PATH
+#define TUNIS_FONT_PATH "fonts.tfp" // font repository loaded by every context, see Context::loadFonts().
+#endif
+
+#ifndef TUNIS_TEXT_LAYOUT_CACHE_SIZE
+#define TUNIS_TEXT_LAYOUT_CACHE_SIZE 1024 // text runs retained by the layout cache.
+#endif
+
+#ifndef TUNIS_REORDER_WINDOW
+#define TUNIS_REORDER_WINDOW 32 // set to 0 to batch the draws in submission order.
 #endif
 
 #include <Tunis.h>
 
+#include <TunisDataTexture.h>
+#include <TunisFontCache.h>
 #include <TunisGL.h>
+#include <TunisGradientRamps.h>
+#include <TunisHash.h>
+#include <TunisImageUploader.h>
+#include <TunisJobSystem.h>
+#include <TunisMappedFile.h>
 #include <TunisPaint.h>
 #include <TunisPath2D.h>
 #include <TunisShaderProgram.h>
 #include <TunisSOA.h>
+#include <TunisStreamBuffer.h>
+#include <TunisTessellationCache.h>
+#include <TunisTextLayoutCache.h>
 #include <TunisTexture.h>
 #include <TunisVertex.h>
 #include <TunisFonts_generated.h>
@@ -59,9 +101,15 @@
 #include <glm/gtx/exterior_product.hpp>
 #include <stb/stb_image.h>
 
-#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
 #include <map>
-#include <thread>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace tunis
 {
@@ -75,28 +123,167 @@ namespace tunis
 
         GraphicStates gfxStates;
 
+        /*!
+         * \brief defaultJobSystem returns the job system shared by every
+         * context that has not been given an executor of its own.
+         */
+        inline JobSystem &defaultJobSystem()
+        {
+            static JobSystem jobSystem(TUNIS_THREAD_COUNT);
+            return jobSystem;
+        }
+
+        /*!
+         * \brief FontPackage is a font repository mapped in memory.
+         */
+        struct FontPackage
+        {
+            MappedFile file;
+            const FontRepository *repository = nullptr;
+        };
+
+        /*!
+         * \brief loadFontPackage maps the font repository at path and verifies
+         * it, or returns the one already loaded from there by another context.
+         * The glyph pages are nested buffers, only verified once they are
+         * looked up, see FontFace.
+         *
+         * \return nullptr if it is missing or invalid.
+         */
+        inline std::shared_ptr<const FontPackage> loadFontPackage(const std::string &path)
+        {
+            static std::mutex mutex;
+            static std::map<std::string, std::weak_ptr<const FontPackage>> packages;
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            std::shared_ptr<const FontPackage> package = packages[path].lock();
+            if (package)
+            {
+                return package;
+            }
+
+            std::shared_ptr<FontPackage> loaded = std::make_shared<FontPackage>();
+            if (!loaded->file.open(path))
+            {
+                return nullptr;
+            }
+
+            flatbuffers::Verifier verifier(loaded->file.data(), loaded->file.size());
+            if (!VerifyFontRepositoryBuffer(verifier))
+            {
+                fprintf(stderr, "%s is not a valid font repository.\n", path.c_str());
+                return nullptr;
+            }
+
+            loaded->repository = GetFontRepository(loaded->file.data());
+            packages[path] = loaded;
+            return loaded;
+        }
+
+        /*!
+         * \brief PathTolerance holds the flattening tolerances of the draw
+         * being tessellated, in path space.
+         */
+        struct PathTolerance
+        {
+            float tess = 0.25f;
+            float dist = 0.01f;
+        };
+
+        /*!
+         * \brief pathTolerance returns the tolerances of the draw being
+         * tessellated by the calling thread. They depend on the transform of
+         * each draw, so they cannot live in the context shared by the workers.
+         */
+        inline PathTolerance &pathTolerance()
+        {
+            static thread_local PathTolerance tolerance;
+            return tolerance;
+        }
+
+        const GLenum IndexType = sizeof(Index) == sizeof(GLuint) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+
+        // maximum number of vertices a single batch can address.
+        const uint64_t MaxBatchVertexCount = static_cast<uint64_t>(std::numeric_limits<Index>::max()) + 1;
+
+        // sort key of the draws that never share their batches.
+        const uint64_t UniqueSortKey = std::numeric_limits<uint64_t>::max();
+
+        // sort keys of the text draws, followed by their atlas page.
+        const uint64_t TextSortKey = static_cast<uint64_t>(1) << 48;
+
+        // two triangles of a quad whose corners go clockwise from its top left
+        // one, wound like the fills of the renderer.
+        const Index QuadIndices[6] = {0, 2, 1, 0, 3, 2};
+
         enum DrawOp
         {
             DRAW_FILL,
+            DRAW_FILL_STENCIL,
+            DRAW_FILL_INSTANCED,
             DRAW_STROKE,
             DRAW_TEXT_FILL,
             DRAW_TEXT_STROKE
         };
 
-        struct BatchArray : public SoA<ShaderProgram*, Texture*, size_t, size_t, Paint>
+        /*!
+         * \brief BatchKind tells how a batch touches the stencil buffer. A
+         * stencil-then-cover fill is a stencil batch holding the fan of every
+         * sub-path, followed by a cover batch holding its bounding quad.
+         */
+        enum class BatchKind : uint8_t
+        {
+            triangles,      // plain triangles, stencil test off.
+            stencilNonZero, // increments front faces, decrements back faces.
+            stencilEvenOdd, // inverts the stencil.
+            cover,          // draws where the stencil is set, and clears it.
+            instances,      // one instanced draw, culling off for mirrored instances.
+        };
+
+        struct BatchArray : public SoA<ShaderProgram*, Texture*, size_t, size_t, size_t, size_t, size_t, BatchKind, size_t, size_t>
         {
             inline ShaderProgram* &program(size_t i) { return get<0>(i); }
-            inline Texture* &texture(size_t i) { return get<1>(i); }
-            inline size_t &offset(size_t i) { return get<2>(i); }
-            inline size_t &count(size_t i) { return get<3>(i); }
-            inline Paint &paint(size_t i) { return get<4>(i); }
+            inline Texture* &texture(size_t i) { return get<1>(i); } // nullptr for the gradient data texture
+            inline size_t &vertexOffset(size_t i) { return get<2>(i); } // in bytes
+            inline size_t &baseVertex(size_t i) { return get<3>(i); } // vertexOffset in vertices
+            inline size_t &vertexCount(size_t i) { return get<4>(i); }
+            inline size_t &offset(size_t i) { return get<5>(i); } // in bytes
+            inline size_t &count(size_t i) { return get<6>(i); }
+            inline BatchKind &kind(size_t i) { return get<7>(i); }
+            inline size_t &instanceOffset(size_t i) { return get<8>(i); } // in bytes
+            inline size_t &instanceCount(size_t i) { return get<9>(i); }
         };
 
-        struct DrawOpArray : public SoA<DrawOp, Path2D, ContextState>
+        struct DrawOpArray : public SoA<DrawOp, Path2D, uint32_t, Mesh*, FillRule, float, uint32_t, uint32_t>
         {
             inline DrawOp &op(size_t i) { return get<0>(i); }
             inline Path2D &path(size_t i) { return get<1>(i); }
-            inline ContextState &state(size_t i) { return get<2>(i); }
+            inline uint32_t &stateId(size_t i) { return get<2>(i); } // index in ContextPriv::drawStates
+            inline Mesh* &mesh(size_t i) { return get<3>(i); }
+            inline FillRule &fillRule(size_t i) { return get<4>(i); }
+            inline float &scale(size_t i) { return get<5>(i); } // see tessellationScale()
+            inline uint32_t &instanceStart(size_t i) { return get<6>(i); } // index in ContextPriv::instances
+            inline uint32_t &instanceCount(size_t i) { return get<7>(i); }
+        };
+
+        /*!
+         * \brief DrawBucket is a run of draws sharing the same sort key, in
+         * the batching order built by ContextPriv::reorderDraws().
+         */
+        struct DrawBucket
+        {
+            uint64_t key;
+            glm::vec2 boundTopLeft;     // of every draw in the bucket, in device space.
+            glm::vec2 boundBottomRight;
+            size_t head;                // first and last draw, chained by drawNext.
+            size_t tail;
+        };
+
+        struct InstanceArray : public SoA<SVGMatrix, Color>
+        {
+            inline SVGMatrix &transform(size_t i) { return get<0>(i); }
+            inline Color &color(size_t i) { return get<1>(i); }
         };
 
         class ContextPriv
@@ -104,39 +291,91 @@ namespace tunis
         public:
             std::vector<ContextState> states;
 
-            std::vector<std::unique_ptr<Texture>> textures;
+            std::vector<std::unique_ptr<Texture>> textures; // the atlas pages.
+            size_t atlasBudget = TUNIS_ATLAS_BUDGET;
+            std::vector<Image> evictionOrder; // scratch of addImage().
+            uint64_t frameIndex = 0;
+            std::unique_ptr<ImageUploader> imageUploader;
+
+            // parameters and color stops of the gradients of the frame, see
+            // gradientTexel().
+            std::unique_ptr<DataTexture> gradientTexture;
+            std::unique_ptr<GradientRamps> gradientRamps;
+            std::vector<glm::vec4> gradientTexels;
+            std::unordered_map<refid_t, float> gradientIndices; // paint id to its first texel.
+            size_t gradientTexelsUploaded = 0;
 
             std::unique_ptr<ShaderProgramTexture> programTexture;
             std::unique_ptr<ShaderProgramGradientLinear> programGradientLinear;
             std::unique_ptr<ShaderProgramGradientRadial> programGradientRadial;
+            std::unique_ptr<ShaderProgramInstance> programInstance;
+            std::unique_ptr<ShaderProgramMsdf> programMsdf;
             GLuint vao = 0;
 
-            enum {
-                VBO = 0,
-                IBO = 1
-            };
-            GLuint buffers[2] = {0, 0};
+            std::unique_ptr<StreamBuffer> vertexStream;
+            std::unique_ptr<StreamBuffer> indexStream;
 
             int32_t viewWidth = 0;
             int32_t viewHeight = 0;
 
-            uint32_t currentVertexOffset = 0;
-            std::vector<uint8_t> vertexBuffer; // write-only interleaved VBO data.
-            std::vector<uint16_t> indexBuffer; // write-only
-
             DrawOpArray renderQueue;
+            InstanceArray instances; // transforms and colors of the instanced draws.
+            GlyphQuadArray glyphQuads; // glyphs of the text draws.
             BatchArray batches;
 
+            // interned states of the queued draws. Slots past drawStateCount
+            // are left over from previous frames and recycled by assignment.
+            std::vector<ContextState> drawStates;
+            size_t drawStateCount = 0;
+
+            // runs the tessellation and image decoding tasks.
+            Executor *executor = nullptr;
+            ParallelFor parallelFor;
+
+            // one sub-path arena per tessellation thread.
+            std::vector<SubPath2DArena> subPathArenas;
+
+            TessellationCache tessellationCache{TUNIS_TESSELLATION_CACHE_BUDGET};
+            std::function<void(bool)> tessellationObserver;
+            std::vector<size_t> pendingDraws; // renderQueue entries missing from the cache.
+            std::vector<float> pendingCosts;  // estimated tessellation cost of pendingDraws.
+            std::vector<size_t> pendingOrder;
+
+            std::vector<size_t> drawOrder; // renderQueue entries, in batching order.
+            std::vector<size_t> drawNext;  // next draw of the same bucket.
+            std::vector<DrawBucket> drawBuckets;
+            size_t keyRunsUnsorted = 0; // runs of draws sharing their sort key, before reorderDraws().
+            size_t keyRunsSorted = 0;   // and after.
+
+            FillMode fillMode = FillMode::triangulate;
+            Mesh coverMesh; // bounding quad of the current stencil-then-cover fill.
+            std::vector<glm::vec2> transformedPositions; // scratch of transformPositions.
+
+            // the text draws are not tessellated: they share this empty path
+            // and mesh, and batch glyphQuads instead.
+            Path2D textPath;
+            Mesh textMesh;
+
+            FrameStats stats;
+
+            bool baseVertexSupported = false;
+            bool instancingSupported = false;
+
             float tessTol = 0.25f;
             float distTol = 0.01f;
 
-            const FontRepository *fontRepo = nullptr;
-            const Font *currentFont = nullptr;
+            std::shared_ptr<const FontPackage> fontPackage;
+            const FontRepository *fontRepo = nullptr; // of fontPackage.
+            FontCache fontCache; // of fontRepo.
 
-            using FontGlyphImageCache = std::map<const Glyph*, Image>;
+            using FontGlyphImageCache = std::unordered_map<const Glyph*, Image>;
 
             FontGlyphImageCache fontGlyphImageCache;
 
+            TextLayoutCache textLayoutCache{TUNIS_TEXT_LAYOUT_CACHE_SIZE};
+            size_t textLayoutHits = 0;   // since the last endFrame().
+            size_t textLayoutMisses = 0;
+
             inline ContextPriv()
             {
                 auto tunisGL_initialized = tunisGLInit();
@@ -145,22 +384,7 @@ namespace tunis
                     abort();
                 }
 
-                std::ifstream inFontfile;
-                inFontfile.open("fonts.tfp", std::ios::binary | std::ios::in);
-                if (inFontfile.is_open())
-                {
-                    inFontfile.seekg(0, std::ios::end);
-                    std::streamsize length = inFontfile.tellg();
-                    inFontfile.seekg(0, std::ios::beg);
-                    char *data = new char[length];
-                    inFontfile.read(data, length);
-                    inFontfile.close();
-
-                    fontRepo = GetFontRepository(data);
-
-                    // Do not delete data: flatbuffers seems to takes ownership of our data pointer
-                }
-
+                loadFonts(TUNIS_FONT_PATH);
 
                 // Create a default texture atlas.
 #ifdef TUNIS_MAX_TEXTURE_SIZE
@@ -176,15 +400,45 @@ namespace tunis
                 std::unique_ptr<Texture> tex = std::unique_ptr<Texture>(new Texture(gfxStates.maxTexSize, gfxStates.maxTexSize));
                 textures.emplace_back(std::move(tex)); // retain
 
+                imageUploader = std::unique_ptr<ImageUploader>(new ImageUploader(TUNIS_UPLOAD_BUDGET));
+
                 Gradient::reserve(64);
                 Image::reserve(64);
                 Paint::reserve(64);
                 Path2D::reserve(64);
                 renderQueue.reserve(1024);
+                glyphQuads.reserve(1024);
+                fontGlyphImageCache.reserve(256);
+                drawStates.reserve(64);
                 batches.reserve(1024);
+                pendingDraws.reserve(1024);
+                pendingCosts.reserve(1024);
+                pendingOrder.reserve(1024);
+                drawOrder.reserve(1024);
+                drawNext.reserve(1024);
+                drawBuckets.reserve(1024);
+                executor = &defaultJobSystem();
+                subPathArenas.resize(executor->concurrency());
+
+                if (sizeof(Index) == sizeof(GLuint) &&
+                    tunisGLSupport(GL_ES_VERSION_2_0) &&
+                    !tunisGLSupport(GL_ES_VERSION_3_0) &&
+                    !tunisGLSupport(GL_OES_element_index_uint))
+                {
+                    fprintf(stderr, "32-bit indices require GL_OES_element_index_uint. Rebuild without TUNIS_INDEX_32BIT.\n");
+                    abort();
+                }
+
+                // With a base vertex, every batch shares the same attribute
+                // pointers instead of re-specifying them at its own offset.
+                baseVertexSupported = tunisGLSupport(GL_VERSION_3_2) ||
+                                      tunisGLSupport(GL_ES_VERSION_3_2) ||
+                                      tunisGLSupport(GL_ARB_draw_elements_base_vertex);
 
-                vertexBuffer.reserve(TUNIS_VERTEX_MAX*sizeof(VertexTexture));
-                indexBuffer.reserve((TUNIS_VERTEX_MAX-2)*3);
+                // Instanced fills need per-instance attributes. Without them,
+                // the instances are expanded on the CPU instead.
+                instancingSupported = tunisGLSupport(GL_VERSION_3_3) ||
+                                      tunisGLSupport(GL_ES_VERSION_3_0);
 
                 if (tunisGLSupport(GL_VERSION_3_0))
                 {
@@ -193,15 +447,29 @@ namespace tunis
                     glBindVertexArray(vao);
                 }
 
-                // Create vertex and index buffer objects for the batches
-                glGenBuffers(2, buffers);
-                glBindBuffer(GL_ARRAY_BUFFER, buffers[ContextPriv::VBO]);
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[ContextPriv::IBO]);
+                // Create the gradient data texture, 256 texels wide, and the
+                // gradient ramps, room for 64 ramps of 256 texels to begin with.
+                // Without float textures, the gradient parameters are packed
+                // in RGBA8 texels instead.
+                gradientTexture = std::unique_ptr<DataTexture>(new DataTexture(256));
+                gradientRamps = std::unique_ptr<GradientRamps>(new GradientRamps(256, 64));
+                gradientTexels.reserve(1024);
+
+                // Create the streaming vertex and index buffer objects for the
+                // batches. The element array binding is part of the VAO state,
+                // so both stay bound for the lifetime of the context.
+                vertexStream = std::unique_ptr<StreamBuffer>(new StreamBuffer(GL_ARRAY_BUFFER, TUNIS_VERTEX_MAX*sizeof(VertexTexture)));
+                indexStream = std::unique_ptr<StreamBuffer>(new StreamBuffer(GL_ELEMENT_ARRAY_BUFFER, TUNIS_VERTEX_MAX*3*sizeof(Index)));
 
                 // Initialize our shader programs.
                 programTexture = std::unique_ptr<ShaderProgramTexture>(new ShaderProgramTexture());
-                programGradientLinear = std::unique_ptr<ShaderProgramGradientLinear>(new ShaderProgramGradientLinear());
-                programGradientRadial = std::unique_ptr<ShaderProgramGradientRadial>(new ShaderProgramGradientRadial());
+                programGradientLinear = std::unique_ptr<ShaderProgramGradientLinear>(new ShaderProgramGradientLinear(gradientTexture->isPacked()));
+                programGradientRadial = std::unique_ptr<ShaderProgramGradientRadial>(new ShaderProgramGradientRadial(gradientTexture->isPacked()));
+                if (instancingSupported)
+                {
+                    programInstance = std::unique_ptr<ShaderProgramInstance>(new ShaderProgramInstance());
+                }
+                programMsdf = std::unique_ptr<ShaderProgramMsdf>(new ShaderProgramMsdf());
 
                 // Use our default texture program.
                 programTexture->useProgram();
@@ -220,18 +488,23 @@ namespace tunis
             inline ~ContextPriv()
             {
                 // unload texture data by deleting every potential texture holders.
+                imageUploader.reset();
                 textures.resize(0);
+                gradientTexture.reset();
+                gradientRamps.reset();
                 batches.resize(0);
+                drawStates.clear();
 
                 // unload shader programs
                 programTexture.reset();
                 programGradientLinear.reset();
                 programGradientRadial.reset();
+                programInstance.reset();
+                programMsdf.reset();
 
                 // unload vertex and index buffers
-                glDeleteBuffers(2, buffers);
-                buffers[ContextPriv::VBO] = 0;
-                buffers[ContextPriv::IBO] = 0;
+                vertexStream.reset();
+                indexStream.reset();
 
                 // reset global states.
                 gfxStates = GraphicStates();
@@ -274,87 +547,103 @@ namespace tunis
             }
 
 
+            /*!
+             * \brief addBatch reserves room for vertexCount vertices and
+             * indexCount indices directly in the streaming buffers, continuing
+             * the last batch when possible.
+             *
+             * Batches of different kinds never continue each other, so the
+             * stencil and cover batches of a fill stay apart from the ones of
+             * its neighbours.
+             *
+             * The paint never breaks a batch: the texture program can use any
+             * texture with the little white square in it, and the vertices of
+             * the gradient programs point at their own gradient in the
+             * gradient data texture.
+             *
+             * Instanced batches also reserve room for instanceCount
+             * VertexInstance right after their vertices, and never continue.
+             *
+             * \return the value to add to the indices written to iout, since
+             * they are relative to the first vertex of the batch.
+             */
             template <typename Vertex_t>
-            inline uint16_t addBatch(ShaderProgram *program, Texture *texture, uint32_t vertexCount, uint32_t indexCount, Vertex_t **vout, Index **iout)
+            inline Index addBatch(ShaderProgram *program, Texture *texture, BatchKind kind, uint32_t vertexCount, uint32_t indexCount, Vertex_t **vout, Index **iout, uint32_t instanceCount = 0)
             {
                 assert(vertexCount >= 3);
+                assert(vertexCount <= MaxBatchVertexCount);
+                assert((kind == BatchKind::instances) == (instanceCount > 0));
 
-                size_t istart = indexBuffer.size();
-                size_t iend = istart + indexCount;
-                indexBuffer.resize(iend);
-                if (iout) *iout = &indexBuffer[istart];
-
-                size_t vstart = vertexBuffer.size();
-                size_t vend = vstart + (vertexCount * sizeof(Vertex_t));
-                vertexBuffer.resize(vend);
-                if (vout) *vout = reinterpret_cast<Vertex_t*>(&vertexBuffer[vstart]);
+                size_t instanceBytes = instanceCount * sizeof(VertexInstance);
+                size_t vertexBytes = vertexCount * sizeof(Vertex_t) + instanceBytes;
+                size_t indexBytes = indexCount * sizeof(Index);
+                size_t vertexOffset, indexOffset;
 
-                uint16_t offset = static_cast<uint16_t>(currentVertexOffset);
-                currentVertexOffset += vertexCount;
+                uint8_t *vertices = vertexStream->allocate(vertexBytes, sizeof(Vertex_t), vertexOffset);
+                uint8_t *indices = indexStream->allocate(indexBytes, sizeof(Index), indexOffset);
 
-                if (batches.size() > 0)
+                if (!vertices || !indices)
                 {
-                    size_t id = batches.size() - 1; // last batch.
-
-                    if (batches.program(id) == program &&
-                        batches.texture(id) == texture)
-                    {
-                        // the batch may continue
-                        batches.count(id) += indexCount;
-                        return offset;
-                    }
+                    // the current segments are full: draw what we have so far
+                    // and move on to the next segments, doubling them so the
+                    // next frames fit in a single one.
+                    flush();
+
+                    auto uploadStart = std::chrono::high_resolution_clock::now();
+                    vertexStream->advance(glm::max(vertexStream->segmentSize() * 2, vertexBytes + sizeof(Vertex_t)));
+                    indexStream->advance(glm::max(indexStream->segmentSize() * 2, indexBytes + sizeof(Index)));
+                    stats.uploadTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - uploadStart).count();
+
+                    vertices = vertexStream->allocate(vertexBytes, sizeof(Vertex_t), vertexOffset);
+                    indices = indexStream->allocate(indexBytes, sizeof(Index), indexOffset);
                 }
 
-                // start a new batch. RenderDefault2D can use any textures for now, as long
-                // as they have that little white square in them.
-                batches.push(std::move(program),
-                             std::move(texture),
-                             std::move(istart),
-                             std::move(indexCount),
-                             {});
-
-                return offset;
-            }
-
-            template <typename Vertex_t>
-            inline uint16_t addBatch(ShaderProgram *program, Texture *texture, Paint paint, uint32_t vertexCount, uint32_t indexCount, Vertex_t **vout, Index **iout)
-            {
-                assert(vertexCount >= 3);
-
-                size_t istart = indexBuffer.size();
-                size_t iend = istart + indexCount;
-                indexBuffer.resize(iend);
-                if (iout) *iout = &indexBuffer[istart];
+                assert(vertices && indices);
 
-                size_t vstart = vertexBuffer.size();
-                size_t vend = vstart + (vertexCount * sizeof(Vertex_t));
-                vertexBuffer.resize(vend);
-                if (vout) *vout = reinterpret_cast<Vertex_t*>(&vertexBuffer[vstart]);
+                if (vout) *vout = reinterpret_cast<Vertex_t*>(vertices);
+                if (iout) *iout = reinterpret_cast<Index*>(indices);
 
-                uint16_t offset = static_cast<uint16_t>(currentVertexOffset);
-                currentVertexOffset += vertexCount;
+                stats.vertexCount += vertexCount;
+                stats.instanceCount += instanceCount;
+                stats.indexCount += indexCount;
 
                 if (batches.size() > 0)
                 {
                     size_t id = batches.size() - 1; // last batch.
 
+                    // Only the last batch allocates from the streams, so its
+                    // vertices and indices are contiguous with the ones we
+                    // just reserved. Past the index range, start a new batch
+                    // rebased on the new vertices instead.
                     if (batches.program(id) == program &&
                         batches.texture(id) == texture &&
-                        batches.paint(id) == paint)
+                        batches.kind(id) == kind &&
+                        kind != BatchKind::instances &&
+                        batches.vertexCount(id) + vertexCount <= MaxBatchVertexCount &&
+                        batches.vertexOffset(id) + batches.vertexCount(id) * sizeof(Vertex_t) == vertexOffset &&
+                        batches.offset(id) + batches.count(id) * sizeof(Index) == indexOffset)
                     {
                         // the batch may continue
+                        Index base = static_cast<Index>(batches.vertexCount(id));
+                        batches.vertexCount(id) += vertexCount;
                         batches.count(id) += indexCount;
-                        return offset;
+                        return base;
                     }
                 }
 
+                // start a new batch.
                 batches.push(std::move(program),
                              std::move(texture),
-                             std::move(istart),
-                             std::move(indexCount),
-                             std::move(paint));
-
-                return offset;
+                             std::move(vertexOffset),
+                             vertexOffset / sizeof(Vertex_t),
+                             vertexCount,
+                             std::move(indexOffset),
+                             indexCount,
+                             std::move(kind),
+                             vertexOffset + vertexBytes - instanceBytes,
+                             std::move(instanceCount));
+
+                return 0;
             }
 
             inline void beginFrame(int w, int h, float devicePixelRatio)
@@ -367,466 +656,510 @@ namespace tunis
 
             inline void endFrame()
             {
+                // keep the storage of the page occupancies from one frame to
+                // the next.
+                std::vector<float> atlasPageOccupancy = std::move(stats.atlasPageOccupancy);
+                atlasPageOccupancy.resize(0);
+                stats = FrameStats();
+                stats.atlasPageOccupancy = std::move(atlasPageOccupancy);
+
+                // the text is laid out while the frame is drawn.
+                stats.textLayoutCacheHits = textLayoutHits;
+                stats.textLayoutCacheMisses = textLayoutMisses;
+                stats.textLayoutCacheSize = textLayoutCache.size();
+                textLayoutHits = 0;
+                textLayoutMisses = 0;
+
                 std::function<void(ContextPriv*)> task;
                 while (detail::taskQueue.try_dequeue(task))
                 {
                     task(this);
                 }
 
+                // before the draws, so the images added by the tasks above, or
+                // evicted then drawn again, start their upload as soon as possible.
+                stats.imageUploadBytes = imageUploader->update();
+                stats.pendingImageUploads = imageUploader->pendingCount();
+
                 // flush the render Queue.
                 if (renderQueue.size() > 0)
                 {
-                    // Generate Geometry (Multi-threaded)
-                    #if defined(_OPENMP)
-                    #pragma omp parallel for num_threads(std::thread::hardware_concurrency())
+                    #if defined(TUNIS_PROFILING)
+                    EASY_BLOCK("Tessellation cache lookup", profiler::colors::DarkRed);
                     #endif
-                    for (long i = 0; i < renderQueue.size(); ++i)
+
+                    // Look up the mesh of every draw. Misses are inserted right
+                    // away, so identical paths drawn several times in the same
+                    // frame are only tessellated once.
+                    pendingDraws.resize(0);
+                    pendingCosts.resize(0);
+                    for (size_t i = 0; i < renderQueue.size(); ++i)
                     {
-                        #if defined(TUNIS_PROFILING) && defined(_OPENMP)
-                        EASY_THREAD_SCOPE("OpenMP trianglation");
-                        #endif
-                        auto &path = renderQueue.path(i);
-                        if (path.dirty())
+                        if (renderQueue.op(i) == DRAW_TEXT_FILL || renderQueue.op(i) == DRAW_TEXT_STROKE)
                         {
-                            switch(renderQueue.op(i))
-                            {
-                                case DRAW_FILL:
-                                    generateContour(path);
-                                    break;
-                                case DRAW_STROKE:
-                                    generateStrokeContour(path, renderQueue.state(i));
-                                    break;
-                            }
+                            renderQueue.mesh(i) = &textMesh;
+                            continue;
+                        }
 
-                            triangulate(path);
+                        Hash key = tessellationKey(renderQueue.op(i), renderQueue.path(i), renderQueue.scale(i), drawStates[renderQueue.stateId(i)]);
 
-                            path.dirty() = false;
+                        Mesh *mesh = tessellationCache.find(key.value, key.check);
+                        if (mesh)
+                        {
+                            ++stats.tessellationCacheHits;
+                        }
+                        else
+                        {
+                            mesh = tessellationCache.insert(key.value, key.check);
+                            pendingDraws.push_back(i);
+                            pendingCosts.push_back(tessellationCost(renderQueue.op(i), renderQueue.path(i), drawStates[renderQueue.stateId(i)]));
+                            ++stats.tessellationCacheMisses;
                         }
+
+                        renderQueue.mesh(i) = mesh;
                     }
 
                     #if defined(TUNIS_PROFILING)
-                    EASY_BLOCK("Batch", profiler::colors::DarkRed);
+                    EASY_END_BLOCK;
                     #endif
 
-                    // Batch Geometry into vertex and index buffers
-                    for (size_t i = 0; i < renderQueue.size(); ++i)
+                    // Generate Geometry (Multi-threaded)
+                    auto tessellationStart = std::chrono::high_resolution_clock::now();
+                    if (subPathArenas.size() < executor->concurrency())
                     {
-                        auto &path = renderQueue.path(i);
-                        auto &state = renderQueue.state(i);
+                        subPathArenas.resize(executor->concurrency());
+                    }
+
+                    // Threads pick the draws up in order, so start with the
+                    // most expensive ones (longest processing time first):
+                    // the cheap ones fill the gaps at the end, instead of one
+                    // thread being left alone with a huge stroke.
+                    if (executor->concurrency() > 1 && pendingDraws.size() > 1)
+                    {
+                        pendingOrder.resize(pendingDraws.size());
+                        for (size_t j = 0; j < pendingOrder.size(); ++j)
+                        {
+                            pendingOrder[j] = j;
+                        }
+                        std::stable_sort(pendingOrder.begin(), pendingOrder.end(), [this](size_t a, size_t b)
+                        {
+                            return pendingCosts[a] > pendingCosts[b];
+                        });
+                        for (size_t j = 0; j < pendingOrder.size(); ++j)
+                        {
+                            pendingOrder[j] = pendingDraws[pendingOrder[j]];
+                        }
+                        pendingDraws.swap(pendingOrder);
+                    }
 
-                        Paint *paint;
+                    if (tessellationObserver)
+                    {
+                        tessellationObserver(true);
+                    }
+
+                    parallelFor(*executor, pendingDraws.size(), [this](size_t j, size_t participant)
+                    {
+                        #if defined(TUNIS_PROFILING)
+                        EASY_THREAD_SCOPE("Tunis worker");
+                        #endif
+                        size_t i = pendingDraws[j];
+                        auto &path = renderQueue.path(i);
+                        SubPath2DArena &subPaths = subPathArenas[participant];
+
+                        // the mesh is transformed while batching, so flatten
+                        // it as finely as it is going to be enlarged.
+                        float scale = renderQueue.scale(i);
+                        PathTolerance &tolerance = pathTolerance();
+                        tolerance.tess = tessTol / (scale * scale);
+                        tolerance.dist = distTol / scale;
                         switch(renderQueue.op(i))
                         {
                             case DRAW_FILL:
-                                paint = &state.fillStyle;
+                            case DRAW_FILL_INSTANCED:
+                                generateContour(path, subPaths);
+                                triangulate(path, subPaths, *renderQueue.mesh(i));
+                                break;
+                            case DRAW_FILL_STENCIL:
+                                generateContour(path, subPaths);
+                                fanOut(path, subPaths, *renderQueue.mesh(i));
                                 break;
                             case DRAW_STROKE:
-                                paint = &state.strokeStyle;
+                                generateStrokeContour(path, drawStates[renderQueue.stateId(i)], subPaths);
+                                triangulate(path, subPaths, *renderQueue.mesh(i));
                                 break;
                         }
 
-                        switch (paint->type())
-                        {
-                            case PaintType::texture:
-                                for(size_t id = 0; id < path.subPathCount(); ++id)
-                                {
-                                    MPEPolyContext &polyContext = path.subPaths()[id].polyContext;
-
-                                    uint32_t vertexCount = polyContext.PointPoolCount;
-                                    uint16_t indexCount = polyContext.TriangleCount*3;
+                        path.dirty() = false;
+                    });
 
-                                    if (vertexCount < 3)
-                                    {
-                                        continue; // not enough vertices to make a fill. Skip
-                                    }
+                    if (tessellationObserver)
+                    {
+                        tessellationObserver(false);
+                    }
 
-                                    VertexTexture *verticies;
-                                    Index *indices;
-                                    uint16_t offset;
+                    stats.tessellationTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tessellationStart).count();
 
-                                    Color color = paint->colorStops().color(0);
-                                    color.a = static_cast<uint8_t>(color.a * state.globalAlpha);
+                    #if defined(TUNIS_PROFILING)
+                    EASY_BLOCK("Batch", profiler::colors::DarkRed);
+                    #endif
 
-                                    // Do we need to render a shadow?
-                                    if (state.shadowColor != Transparent && (glm::epsilonNotEqual(state.shadowOffsetX, 0.0f, glm::epsilon<float>()) || glm::epsilonNotEqual(state.shadowOffsetY, 0.0f, glm::epsilon<float>())))
-                                    {
-                                        Color shadowColor = state.shadowColor;
-                                        shadowColor.a = static_cast<uint8_t>((shadowColor.a/255.0f * color.a/255.0f) * 0xFF);
-
-                                        offset = addBatch(programTexture.get(),
-                                                          textures.back().get(),
-                                                          vertexCount,
-                                                          indexCount,
-                                                          &verticies,
-                                                          &indices);
-
-                                        //populate the shadow vertices
-                                        for (size_t vid = 0; vid < polyContext.PointPoolCount; ++vid)
-                                        {
-                                            MPEPolyPoint &Point = polyContext.PointsPool[vid];
-                                            glm::vec2 pos(Point.X + state.shadowOffsetX,
-                                                          Point.Y + state.shadowOffsetY);
-                                            glm::vec2 tcoord = pos * gfxStates.pixelWidth;
-
-                                            verticies[vid].a_position = pos;
-                                            verticies[vid].a_texcoord.s = static_cast<uint16_t>(tcoord.s);
-                                            verticies[vid].a_texcoord.t = static_cast<uint16_t>(tcoord.t);
-                                            verticies[vid].a_texoffset.s = static_cast<uint16_t>(0);
-                                            verticies[vid].a_texoffset.t = static_cast<uint16_t>(0);
-                                            verticies[vid].a_texsize.s = static_cast<uint16_t>(1);
-                                            verticies[vid].a_texsize.t = static_cast<uint16_t>(1);
-                                            verticies[vid].a_color = shadowColor;
-                                        }
+                    reorderDraws();
 
-                                        //populate the indicies
-                                        for (size_t tid = 0; tid < polyContext.TriangleCount; ++tid)
-                                        {
-                                            MPEPolyTriangle* triangle = polyContext.Triangles[tid];
+                    // Batch Geometry into vertex and index buffers
+                    for (size_t n = 0; n < drawOrder.size(); ++n)
+                    {
+                        size_t i = drawOrder[n];
+                        const Mesh &mesh = *renderQueue.mesh(i);
+                        const ContextState &state = drawStates[renderQueue.stateId(i)];
+                        const SVGMatrix &transform = state.currentTransform;
 
-                                            // get the array index by pointer address arithmetic.
-                                            uint16_t p0 = static_cast<uint16_t>(triangle->Points[0] - polyContext.PointsPool);
-                                            uint16_t p1 = static_cast<uint16_t>(triangle->Points[1] - polyContext.PointsPool);
-                                            uint16_t p2 = static_cast<uint16_t>(triangle->Points[2] - polyContext.PointsPool);
+                        if (renderQueue.op(i) == DRAW_TEXT_FILL || renderQueue.op(i) == DRAW_TEXT_STROKE)
+                        {
+                            addGlyphs(state, renderQueue.op(i) == DRAW_TEXT_STROKE, renderQueue.instanceStart(i), renderQueue.instanceCount(i));
+                            continue;
+                        }
 
-                                            size_t iid = tid * 3;
-                                            indices[iid+0] = offset+p2;
-                                            indices[iid+1] = offset+p1;
-                                            indices[iid+2] = offset+p0;
-                                        }
+                        if (mesh.subMeshes.size() == 0)
+                        {
+                            continue; // nothing to draw.
+                        }
 
-                                    }
+                        if (renderQueue.op(i) == DRAW_FILL_INSTANCED)
+                        {
+                            addInstances(mesh, state, renderQueue.instanceStart(i), renderQueue.instanceCount(i));
+                            continue;
+                        }
 
-                                    offset = addBatch(programTexture.get(),
-                                                      textures.back().get(),
-                                                      vertexCount,
-                                                      indexCount,
-                                                      &verticies,
-                                                      &indices);
+                        const Paint *paint;
+                        switch(renderQueue.op(i))
+                        {
+                            case DRAW_FILL:
+                            case DRAW_FILL_STENCIL:
+                                paint = &state.fillStyle;
+                                break;
+                            case DRAW_STROKE:
+                                paint = &state.strokeStyle;
+                                break;
+                        }
 
-                                    glm::vec2 shapeSize = path.boundBottomRight() - path.boundTopLeft();
-                                    glm::vec2 texoffset = glm::vec2(paint->image().bounds().x(), paint->image().bounds().y()) * gfxStates.pixelWidth;
-                                    glm::vec2 texsize = glm::vec2(paint->image().bounds().width(), paint->image().bounds().height()) * gfxStates.pixelWidth;
-                                    glm::vec2 texscale;
+                        // Stencil-then-cover fills paint their bounding quad,
+                        // once their mesh has been written to the stencil.
+                        bool stencil = renderQueue.op(i) == DRAW_FILL_STENCIL;
+                        FillRule fillRule = renderQueue.fillRule(i);
+                        const Mesh &geometry = stencil ? coverQuad(mesh) : mesh;
+                        BatchKind kind = stencil ? BatchKind::cover : BatchKind::triangles;
 
-                                    switch (paint->repetition())
-                                    {
-                                        case RepeatType::repeat:
-                                            texscale = glm::vec2(gfxStates.pixelWidth, gfxStates.pixelWidth);
-                                            break;
-                                        case RepeatType::repeat_x:
-                                            texscale.x = gfxStates.pixelWidth;
-                                            texscale.y = texsize.y / shapeSize.y;
-                                            break;
-                                        case RepeatType::repeat_y:
-                                            texscale.x = texsize.x / shapeSize.x;
-                                            texscale.y = gfxStates.pixelWidth;
-                                            break;
-                                        case RepeatType::no_repeat:
-                                            texscale = texsize / shapeSize;
-                                            break;
-                                    }
+                        switch (paint->type())
+                        {
+                            case PaintType::texture:
+                            {
+                                Rect<int32_t> bounds;
+                                Texture *texture = residentTexture(paint->image(), bounds);
 
-                                    //populate the vertices
-                                    for (size_t vid = 0; vid < polyContext.PointPoolCount; ++vid)
-                                    {
-                                        MPEPolyPoint &Point = polyContext.PointsPool[vid];
-                                        glm::vec2 pos(Point.X, Point.Y);
-                                        glm::vec2 tcoord = texscale * pos;
-
-                                        verticies[vid].a_position = pos;
-                                        verticies[vid].a_texcoord.s = static_cast<uint16_t>(tcoord.s);
-                                        verticies[vid].a_texcoord.t = static_cast<uint16_t>(tcoord.t);
-                                        verticies[vid].a_texoffset.s = static_cast<uint16_t>(texoffset.s);
-                                        verticies[vid].a_texoffset.t = static_cast<uint16_t>(texoffset.t);
-                                        verticies[vid].a_texsize.s = static_cast<uint16_t>(texsize.s);
-                                        verticies[vid].a_texsize.t = static_cast<uint16_t>(texsize.t);
-                                        verticies[vid].a_color = color;
-                                    }
+                                Color color = paint->colorStops().color(0);
+                                color.a = static_cast<uint8_t>(color.a * state.globalAlpha);
 
-                                    //populate the indicies
-                                    for (size_t tid = 0; tid < polyContext.TriangleCount; ++tid)
-                                    {
-                                        MPEPolyTriangle* triangle = polyContext.Triangles[tid];
+                                // Do we need to render a shadow?
+                                bool shadow = hasShadow(state);
+                                Color shadowColor = state.shadowColor;
+                                shadowColor.a = static_cast<uint8_t>((shadowColor.a/255.0f * color.a/255.0f) * 0xFF);
+                                glm::vec2 shadowOffset(state.shadowOffsetX, state.shadowOffsetY);
 
-                                        // get the array index by pointer address arithmetic.
-                                        uint16_t p0 = static_cast<uint16_t>(triangle->Points[0] - polyContext.PointsPool);
-                                        uint16_t p1 = static_cast<uint16_t>(triangle->Points[1] - polyContext.PointsPool);
-                                        uint16_t p2 = static_cast<uint16_t>(triangle->Points[2] - polyContext.PointsPool);
+                                glm::vec2 shapeSize = mesh.boundBottomRight - mesh.boundTopLeft;
+                                glm::vec2 texoffset = glm::vec2(bounds.x(), bounds.y()) * gfxStates.pixelWidth;
+                                glm::vec2 texsize = glm::vec2(bounds.width(), bounds.height()) * gfxStates.pixelWidth;
+                                glm::vec2 texscale;
 
-                                        size_t iid = tid * 3;
-                                        indices[iid+0] = offset+p2;
-                                        indices[iid+1] = offset+p1;
-                                        indices[iid+2] = offset+p0;
-                                    }
-                                }
-                                break;
-                            case PaintType::gradientLinear:
-                                for(size_t id = 0; id < path.subPathCount(); ++id)
+                                switch (paint->repetition())
                                 {
-                                    MPEPolyContext &polyContext = path.subPaths()[id].polyContext;
-
-                                    uint32_t vertexCount = polyContext.PointPoolCount;
-                                    uint16_t indexCount = polyContext.TriangleCount*3;
-
-                                    if (vertexCount < 3)
-                                    {
-                                        continue; // not enough vertices to make a fill. Skip
-                                    }
+                                    case RepeatType::repeat:
+                                        texscale = glm::vec2(gfxStates.pixelWidth, gfxStates.pixelWidth);
+                                        break;
+                                    case RepeatType::repeat_x:
+                                        texscale.x = gfxStates.pixelWidth;
+                                        texscale.y = texsize.y / shapeSize.y;
+                                        break;
+                                    case RepeatType::repeat_y:
+                                        texscale.x = texsize.x / shapeSize.x;
+                                        texscale.y = gfxStates.pixelWidth;
+                                        break;
+                                    case RepeatType::no_repeat:
+                                        texscale = texsize / shapeSize;
+                                        break;
+                                }
 
-                                    VertexGradient *verticies;
-                                    Index *indices;
-                                    uint16_t offset = addBatch(programGradientLinear.get(),
-                                                               textures.back().get(),
-                                                               *paint,
-                                                               vertexCount,
-                                                               indexCount,
-                                                               &verticies,
-                                                               &indices);
-
-                                    //populate the vertices
-                                    for (size_t vid = 0; vid < polyContext.PointPoolCount; ++vid)
+                                if (shadow)
+                                {
+                                    if (stencil)
                                     {
-                                        MPEPolyPoint &Point = polyContext.PointsPool[vid];
-                                        verticies[vid].a_position.x = Point.X;
-                                        verticies[vid].a_position.y = Point.Y;
+                                        addStencil(mesh, transform, shadowOffset, fillRule);
                                     }
+                                    addTextureGeometry(geometry, texture, kind, transform, shadowOffset,
+                                                       glm::vec2(gfxStates.pixelWidth),
+                                                       glm::vec2(0.0f), glm::vec2(1.0f),
+                                                       shadowColor);
+                                }
 
-                                    //populate the indicies
-                                    for (size_t tid = 0; tid < polyContext.TriangleCount; ++tid)
-                                    {
-                                        MPEPolyTriangle* triangle = polyContext.Triangles[tid];
-
-                                        // get the array index by pointer address arithmetic.
-                                        uint16_t p0 = static_cast<uint16_t>(triangle->Points[0] - polyContext.PointsPool);
-                                        uint16_t p1 = static_cast<uint16_t>(triangle->Points[1] - polyContext.PointsPool);
-                                        uint16_t p2 = static_cast<uint16_t>(triangle->Points[2] - polyContext.PointsPool);
-
-                                        size_t iid = tid * 3;
-                                        indices[iid+0] = offset+p2;
-                                        indices[iid+1] = offset+p1;
-                                        indices[iid+2] = offset+p0;
-                                    }
+                                if (stencil)
+                                {
+                                    addStencil(mesh, transform, glm::vec2(0.0f), fillRule);
                                 }
+                                addTextureGeometry(geometry, texture, kind, transform, glm::vec2(0.0f),
+                                                   texscale, texoffset, texsize,
+                                                   color);
                                 break;
+                            }
+                            case PaintType::gradientLinear:
                             case PaintType::gradientRadial:
-                                for(size_t id = 0; id < path.subPathCount(); ++id)
-                                {
-                                    MPEPolyContext &polyContext = path.subPaths()[id].polyContext;
-
-                                    uint32_t vertexCount = polyContext.PointPoolCount;
-                                    uint16_t indexCount = polyContext.TriangleCount*3;
-
-                                    if (vertexCount < 3)
-                                    {
-                                        continue; // not enough vertices to make a fill. Skip
-                                    }
-
-                                    VertexGradient *verticies;
-                                    Index *indices;
-                                    uint16_t offset = addBatch(programGradientRadial.get(),
-                                                               textures.back().get(),
-                                                               *paint,
-                                                               vertexCount,
-                                                               indexCount,
-                                                               &verticies,
-                                                               &indices);
-
-                                    //populate the vertices
-                                    for (size_t vid = 0; vid < polyContext.PointPoolCount; ++vid)
-                                    {
-                                        MPEPolyPoint &Point = polyContext.PointsPool[vid];
-                                        verticies[vid].a_position.x = Point.X;
-                                        verticies[vid].a_position.y = Point.Y;
-                                    }
-
-                                    //populate the indicies
-                                    for (size_t tid = 0; tid < polyContext.TriangleCount; ++tid)
-                                    {
-                                        MPEPolyTriangle* triangle = polyContext.Triangles[tid];
-
-                                        // get the array index by pointer address arithmetic.
-                                        uint16_t p0 = static_cast<uint16_t>(triangle->Points[0] - polyContext.PointsPool);
-                                        uint16_t p1 = static_cast<uint16_t>(triangle->Points[1] - polyContext.PointsPool);
-                                        uint16_t p2 = static_cast<uint16_t>(triangle->Points[2] - polyContext.PointsPool);
+                            {
+                                ShaderProgram *program = paint->type() == PaintType::gradientLinear ?
+                                            static_cast<ShaderProgram*>(programGradientLinear.get()) :
+                                            static_cast<ShaderProgram*>(programGradientRadial.get());
 
-                                        size_t iid = tid * 3;
-                                        indices[iid+0] = offset+p2;
-                                        indices[iid+1] = offset+p1;
-                                        indices[iid+2] = offset+p0;
-                                    }
+                                if (stencil)
+                                {
+                                    addStencil(mesh, transform, glm::vec2(0.0f), fillRule);
                                 }
+                                addGradientGeometry(geometry, kind, transform, program, *paint);
                                 break;
+                            }
                         }
 
                     }
 
                     renderQueue.resize(0);
+                    instances.resize(0);
+                    glyphQuads.resize(0);
+                    drawStateCount = 0;
+
+                    #if defined(TUNIS_PROFILING)
+                    EASY_END_BLOCK;
+                    #endif
                 }
-                #if defined(TUNIS_PROFILING)
-                EASY_END_BLOCK;
-                #endif
 
+                // the meshes have been copied into the streams, so the cache can
+                // now evict the ones it no longer has room for.
+                tessellationCache.collect();
+                stats.tessellationCacheSize = tessellationCache.memoryUsage();
 
-                #if defined(TUNIS_PROFILING)
-                EASY_BLOCK("glBufferData", profiler::colors::DarkRed);
-                #endif
-                // flush the vertex buffer.
-                if (vertexBuffer.size() > 0) {
-                    glBufferData(GL_ARRAY_BUFFER,
-                                 static_cast<GLsizeiptr>(vertexBuffer.size() * sizeof(VertexTexture)),
-                                 vertexBuffer.data(),
-                                 GL_STREAM_DRAW);
-                    vertexBuffer.resize(0);
-                    currentVertexOffset = 0;
+                // draw the remaining batches.
+                flush();
+
+                gradientTexels.resize(0);
+                gradientIndices.clear();
+                gradientTexelsUploaded = 0;
+                gradientRamps->endFrame();
+
+                // free the atlas room of the images dropped by the user.
+                for (size_t i = 0; i < textures.size(); ++i)
+                {
+                    textures[i]->collect();
+                    stats.atlasMemory += textures[i]->memoryUsage();
+                    stats.atlasPageOccupancy.push_back(textures[i]->occupancy());
                 }
+                ++frameIndex;
+
+                // every run of draws sharing a key costs at least one batch,
+                // so the reordering saved the runs it merged.
+                size_t unsortedDrawCallCount = stats.drawCallCount + keyRunsUnsorted;
+                stats.unsortedDrawCallCount = unsortedDrawCallCount > keyRunsSorted ? unsortedDrawCallCount - keyRunsSorted : stats.drawCallCount;
+                keyRunsUnsorted = 0;
+                keyRunsSorted = 0;
+
+                // fence the segments we just filled and move on to the next ones.
+                auto uploadStart = std::chrono::high_resolution_clock::now();
+                vertexStream->advance();
+                indexStream->advance();
+                stats.uploadTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - uploadStart).count();
+            }
 
+            /*!
+             * \brief flush hands the pending vertices and indices over to GL and
+             * draws every pending batch.
+             */
+            inline void flush()
+            {
+                if (batches.size() == 0)
+                {
+                    return;
+                }
 
-                // flush the index buffer.
-                if (indexBuffer.size() > 0) {
-                    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                                 static_cast<GLsizeiptr>(indexBuffer.size() * sizeof(uint16_t)),
-                                 indexBuffer.data(),
-                                 GL_STREAM_DRAW);
-                    indexBuffer.resize(0);
+                #if defined(TUNIS_PROFILING)
+                EASY_BLOCK("Upload", profiler::colors::DarkRed);
+                #endif
+                auto uploadStart = std::chrono::high_resolution_clock::now();
+                vertexStream->flush();
+                indexStream->flush();
+                if (gradientTexels.size() > gradientTexelsUploaded)
+                {
+                    gradientTexture->upload(gradientTexels.data(), gradientTexels.size());
+                    gradientTexelsUploaded = gradientTexels.size();
                 }
+                stats.uploadTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - uploadStart).count();
                 #if defined(TUNIS_PROFILING)
                 EASY_END_BLOCK;
                 #endif
 
-                // flush the batches
-                if ( batches.size() > 0)
+                #if defined(TUNIS_PROFILING)
+                EASY_BLOCK("glDrawElements", profiler::colors::DarkRed);
+                #endif
+                BatchKind currentKind = BatchKind::triangles;
+                for (size_t i = 0; i < batches.size(); ++i)
                 {
-                    #if defined(TUNIS_PROFILING)
-                    EASY_BLOCK("glDrawElements", profiler::colors::DarkRed);
-                    #endif
-                    for (size_t i = 0; i < batches.size(); ++i)
+                    if (batches.kind(i) != currentKind)
                     {
-                        batches.program(i)->useProgram();
-                        batches.program(i)->setViewSizeUniform(viewWidth, viewHeight);
-
-                        const Paint &paint = batches.paint(i);
-                        if (paint.type() == detail::PaintType::gradientLinear)
-                        {
-                            detail::UniformBlock uniforms;
+                        currentKind = batches.kind(i);
+                        setBatchKind(currentKind);
+                    }
 
-                            glm::vec2 start = paint.start();
-                            glm::vec2 end = paint.end();
+                    batches.program(i)->useProgram();
+                    batches.program(i)->setViewSizeUniform(viewWidth, viewHeight);
+                    batches.program(i)->setVertexOffset(baseVertexSupported ? 0 : batches.vertexOffset(i));
 
-                            start.y = viewHeight - start.y ;
-                            end.y = viewHeight - end.y ;
+                    if (batches.texture(i))
+                    {
+                        batches.texture(i)->bind();
+                        batches.texture(i)->updateMipmap();
+                    }
+                    else
+                    {
+                        gradientTexture->bind();
+                        ShaderProgramGradient *program = static_cast<ShaderProgramGradient*>(batches.program(i));
+                        program->setGradientsSizeUniform(gradientTexture->width(), gradientTexture->height());
+                        program->setRampsSizeUniform(gradientRamps->width(), gradientRamps->height());
+                    }
 
-                            glm::vec2 dt = end - start;
+                    if (batches.kind(i) == BatchKind::instances)
+                    {
+                        ShaderProgramInstance *program = static_cast<ShaderProgramInstance*>(batches.program(i));
+                        program->enableInstanceAttribArray(batches.instanceOffset(i));
 
-                            uniforms.linearGradient.u_start = start;
-                            uniforms.linearGradient.u_dt = dt;
-                            uniforms.linearGradient.u_lenSq = glm::dot(dt, dt);
-
-                            size_t colorStopCount = glm::min<size_t>(4, paint.colorStops().size());
-
-                            uniforms.linearGradient.u_colorStopCount = colorStopCount;
-
-                            for (size_t j = 0; j < colorStopCount; ++j)
-                            {
-                                uniforms.linearGradient.u_offset[j] = paint.colorStops().offset(j);
-                                uniforms.linearGradient.u_color[j].r = paint.colorStops().color(j).r / 255.0f;
-                                uniforms.linearGradient.u_color[j].g = paint.colorStops().color(j).g / 255.0f;
-                                uniforms.linearGradient.u_color[j].b = paint.colorStops().color(j).b / 255.0f;
-                                uniforms.linearGradient.u_color[j].a = paint.colorStops().color(j).a / 255.0f;
-                            }
-
-                            static_cast<ShaderProgramGradient*>(batches.program(i))->setUniforms(uniforms);
+                        if (baseVertexSupported)
+                        {
+                            glDrawElementsInstancedBaseVertex(GL_TRIANGLES,
+                                                              static_cast<GLsizei>(batches.count(i)),
+                                                              IndexType,
+                                                              reinterpret_cast<void*>(batches.offset(i)),
+                                                              static_cast<GLsizei>(batches.instanceCount(i)),
+                                                              static_cast<GLint>(batches.baseVertex(i)));
                         }
-                        else if (paint.type() == detail::PaintType::gradientRadial)
+                        else
                         {
-                            detail::UniformBlock uniforms;
-
-                            glm::vec2 center = paint.start();
-                            glm::vec2 focal = paint.end();
-
-                            center.y = viewHeight - center.y ;
-                            focal.y = viewHeight - focal.y ;
-
-                            glm::vec2 dt = focal - center;
-                            float dr = paint.radius().x - paint.radius().y;
-
-                            uniforms.radialGradient.u_dt = dt;
-                            uniforms.radialGradient.u_focal = focal;
-                            uniforms.radialGradient.u_r0 = paint.radius().y;
-                            uniforms.radialGradient.u_dr = dr;
-                            uniforms.radialGradient.u_a = dt.x * dt.x + dt.y * dt.y - dr * dr;
-
-                            size_t colorStopCount = glm::min<size_t>(4, paint.colorStops().size());
-
-                            uniforms.radialGradient.u_colorStopCount = colorStopCount;
-
-                            for (size_t j = 0; j < colorStopCount; ++j)
-                            {
-                                uniforms.radialGradient.u_offset[j] = paint.colorStops().offset(j);
-                                uniforms.radialGradient.u_color[j].r = paint.colorStops().color(j).r / 255.0f;
-                                uniforms.radialGradient.u_color[j].g = paint.colorStops().color(j).g / 255.0f;
-                                uniforms.radialGradient.u_color[j].b = paint.colorStops().color(j).b / 255.0f;
-                                uniforms.radialGradient.u_color[j].a = paint.colorStops().color(j).a / 255.0f;
-                            }
-
-                            static_cast<ShaderProgramGradient*>(batches.program(i))->setUniforms(uniforms);
+                            glDrawElementsInstanced(GL_TRIANGLES,
+                                                    static_cast<GLsizei>(batches.count(i)),
+                                                    IndexType,
+                                                    reinterpret_cast<void*>(batches.offset(i)),
+                                                    static_cast<GLsizei>(batches.instanceCount(i)));
                         }
 
-                        batches.texture(i)->bind();
-                        batches.texture(i)->updateMipmap();
-
+                        program->disableInstanceAttribArray();
+                        continue;
+                    }
 
 #if 1
+                    if (baseVertexSupported)
+                    {
+                        glDrawElementsBaseVertex(GL_TRIANGLES,
+                                                 static_cast<GLsizei>(batches.count(i)),
+                                                 IndexType,
+                                                 reinterpret_cast<void*>(batches.offset(i)),
+                                                 static_cast<GLint>(batches.baseVertex(i)));
+                    }
+                    else
+                    {
                         glDrawElements(GL_TRIANGLES,
                                        static_cast<GLsizei>(batches.count(i)),
-                                       GL_UNSIGNED_SHORT,
-                                       reinterpret_cast<void*>(batches.offset(i) * sizeof(GLushort)));
+                                       IndexType,
+                                       reinterpret_cast<void*>(batches.offset(i)));
+                    }
 #endif
 
 #if 0
-                        // Helpful code for debugging triangles.
-                        for (size_t j = 0; j < batches.count(i)/3; ++j)
-                        {
-                            glDrawElements(GL_LINE_LOOP,
-                                           3,
-                                           GL_UNSIGNED_SHORT,
-                                           reinterpret_cast<void*>((batches.offset(i)+(j*3)) * sizeof(GLushort)));
-                        }
+                    // Helpful code for debugging triangles.
+                    for (size_t j = 0; j < batches.count(i)/3; ++j)
+                    {
+                        glDrawElements(GL_LINE_LOOP,
+                                       3,
+                                       IndexType,
+                                       reinterpret_cast<void*>(batches.offset(i) + (j*3) * sizeof(Index)));
+                    }
 #endif
 
 #if 0
-                        // Helpful code for debugging contours.
-                        glDrawElements(GL_LINE_STRIP,
-                                       static_cast<GLsizei>(batches.count(i)),
-                                       GL_UNSIGNED_SHORT,
-                                       reinterpret_cast<void*>(batches.offset(i) * sizeof(GLushort)));
+                    // Helpful code for debugging contours.
+                    glDrawElements(GL_LINE_STRIP,
+                                   static_cast<GLsizei>(batches.count(i)),
+                                   IndexType,
+                                   reinterpret_cast<void*>(batches.offset(i)));
 #endif
 
-                    }
+                }
 
-                    batches.resize(0);
+                if (currentKind != BatchKind::triangles)
+                {
+                    setBatchKind(BatchKind::triangles);
                 }
 
+                stats.drawCallCount += batches.size();
+                batches.resize(0);
+
+                #if defined(TUNIS_PROFILING)
+                EASY_END_BLOCK;
+                #endif
             }
 
-            inline size_t addSubPath(Path2D &path)
+            /*!
+             * \brief setBatchKind sets the stencil, color mask and culling
+             * states used to draw the batches of the given kind.
+             */
+            static inline void setBatchKind(BatchKind kind)
             {
-                size_t id = path.subPathCount()++;
-
-                SubPath2D &subPath = path.subPaths()[id];
-
-                subPath.mempool.resize(0);
-                subPath.points.resize(0);
-                subPath.innerPoints.resize(0);
-                subPath.outerPoints.resize(0);
-                subPath.closed = false;
-
-                return id;
+                switch (kind)
+                {
+                    case BatchKind::triangles:
+                        glDisable(GL_STENCIL_TEST);
+                        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                        glEnable(GL_CULL_FACE);
+                        break;
+                    case BatchKind::stencilNonZero:
+                    case BatchKind::stencilEvenOdd:
+                        glEnable(GL_STENCIL_TEST);
+                        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                        glDisable(GL_CULL_FACE); // the fans are wound both ways.
+                        glStencilMask(0xFF);
+                        glStencilFunc(GL_ALWAYS, 0, 0xFF);
+                        if (kind == BatchKind::stencilNonZero)
+                        {
+                            glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+                            glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+                        }
+                        else
+                        {
+                            glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT);
+                        }
+                        break;
+                    case BatchKind::instances:
+                        glDisable(GL_STENCIL_TEST);
+                        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                        glDisable(GL_CULL_FACE); // instances may be mirrored.
+                        break;
+                    case BatchKind::cover:
+                        glEnable(GL_STENCIL_TEST);
+                        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                        glEnable(GL_CULL_FACE);
+                        // the even-odd stencil is either 0 or 0xFF, so both
+                        // rules test the same way. Clearing what we cover
+                        // leaves a clean stencil for the next fill.
+                        glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+                        glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
+                        break;
+                }
             }
 
-            inline size_t addSubPath(Path2D &path, glm::vec2 startPos)
+            inline size_t addSubPath(SubPath2DArena &subPaths, glm::vec2 startPos)
             {
-                size_t id = addSubPath(path);
-                path.subPaths()[id].points.push(std::move(startPos), {}, {}, 0.0f, PointProperties::corner);
+                size_t id = subPaths.add();
+                subPaths[id].points.push(std::move(startPos), {}, {}, 0.0f, PointProperties::corner);
                 return id;
             }
 
@@ -834,7 +1167,7 @@ namespace tunis
             {
                 if (points.size() > 0)
                 {
-                    if (glm::all(glm::epsilonEqual(points[points.size() - 1], pos, distTol)))
+                    if (glm::all(glm::epsilonEqual(points[points.size() - 1], pos, pathTolerance().dist)))
                     {
                         return;
                     }
@@ -847,7 +1180,7 @@ namespace tunis
             {
                 if (points.size() > 0)
                 {
-                    if (glm::all(glm::epsilonEqual(points.pos(points.size() - 1), pos, distTol)))
+                    if (glm::all(glm::epsilonEqual(points.pos(points.size() - 1), pos, pathTolerance().dist)))
                     {
                         return;
                     }
@@ -946,7 +1279,7 @@ namespace tunis
                         }
                         if(d2 > d3)
                         {
-                            if(d2 < tessTol)
+                            if(d2 < pathTolerance().tess)
                             {
                                 addPoint(points, glm::vec2(x2, y2), PointProperties::none);
                                 return;
@@ -954,7 +1287,7 @@ namespace tunis
                         }
                         else
                         {
-                            if(d3 < tessTol)
+                            if(d3 < pathTolerance().tess)
                             {
                                 addPoint(points, glm::vec2(x3, y3), PointProperties::none);
                                 return;
@@ -965,7 +1298,7 @@ namespace tunis
                     case 1:
                         // p1,p2,p4 are collinear, p3 is significant
                         //----------------------
-                        if(d3 * d3 <= tessTol * (dx*dx + dy*dy))
+                        if(d3 * d3 <= pathTolerance().tess * (dx*dx + dy*dy))
                         {
                             addPoint(points, glm::vec2(x23, y23), PointProperties::none);
                             return;
@@ -975,7 +1308,7 @@ namespace tunis
                     case 2:
                         // p1,p3,p4 are collinear, p2 is significant
                         //----------------------
-                        if(d2 * d2 <= tessTol * (dx*dx + dy*dy))
+                        if(d2 * d2 <= pathTolerance().tess * (dx*dx + dy*dy))
                         {
                             addPoint(points, glm::vec2(x23, y23), PointProperties::none);
                             return;
@@ -985,7 +1318,7 @@ namespace tunis
                     case 3:
                         // Regular case
                         //-----------------
-                        if((d2 + d3)*(d2 + d3) <= tessTol * (dx*dx + dy*dy))
+                        if((d2 + d3)*(d2 + d3) <= pathTolerance().tess * (dx*dx + dy*dy))
                         {
                             addPoint(points, glm::vec2(x23, y23), PointProperties::none);
                             return;
@@ -1089,25 +1422,25 @@ namespace tunis
             template <typename PointArray>
             inline void arcTo(PointArray &points, glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, float radius)
             {
-                if (glm::all(glm::epsilonEqual(p0, p1, distTol)))
+                if (glm::all(glm::epsilonEqual(p0, p1, pathTolerance().dist)))
                 {
                     addPoint(points, p1, PointProperties::corner);
                     return;
                 }
 
-                if (glm::all(glm::epsilonEqual(p1, p2, distTol)))
+                if (glm::all(glm::epsilonEqual(p1, p2, pathTolerance().dist)))
                 {
                     addPoint(points, p1, PointProperties::corner);
                     return;
                 }
 
-                if (distPtSeg(p1, p0, p2) < (distTol * distTol))
+                if (distPtSeg(p1, p0, p2) < (pathTolerance().dist * pathTolerance().dist))
                 {
                     addPoint(points, p1, PointProperties::corner);
                     return;
                 }
 
-                if (radius < distTol)
+                if (radius < pathTolerance().dist)
                 {
                     addPoint(points, p1, PointProperties::corner);
                     return;
@@ -1150,16 +1483,15 @@ namespace tunis
             }
 
 
-            inline void generateContour(Path2D &path)
+            inline void generateContour(Path2D &path, SubPath2DArena &subPaths)
             {
                 #if defined(TUNIS_PROFILING)
                 EASY_FUNCTION(profiler::colors::DarkRed);
                 #endif
-                SubPath2DArray &subPaths = path.subPaths();
                 PathCommandArray &commands = path.commands();
 
                 // reset to default.
-                path.subPathCount() = 0;
+                subPaths.reset();
 
                 size_t id = 0;
 
@@ -1168,21 +1500,21 @@ namespace tunis
                     switch(commands.type(i))
                     {
                         case PathCommandType::close:
-                            if (path.subPathCount() > 0)
+                            if (subPaths.size() > 0)
                             {
                                 subPaths[id].closed = true;
                             }
                             break;
                         case PathCommandType::moveTo:
-                            id = addSubPath(path, glm::vec2(commands.param0(i), commands.param1(i)));
+                            id = addSubPath(subPaths, glm::vec2(commands.param0(i), commands.param1(i)));
                             break;
                         case PathCommandType::lineTo:
-                            if (path.subPathCount() == 0) { id = addSubPath(path, glm::vec2(0.0f)); }
+                            if (subPaths.size() == 0) { id = addSubPath(subPaths, glm::vec2(0.0f)); }
                             addPoint(subPaths[id].points, glm::vec2(commands.param0(i), commands.param1(i)), PointProperties::corner);
                             break;
                         case PathCommandType::bezierCurveTo:
                         {
-                            if (path.subPathCount() == 0) { id = addSubPath(path, glm::vec2(0.0f)); }
+                            if (subPaths.size() == 0) { id = addSubPath(subPaths, glm::vec2(0.0f)); }
                             auto &points = subPaths[id].points;
                             auto &prevPoint = points.pos(points.size()-1);
                             bezierTo(points,
@@ -1195,7 +1527,7 @@ namespace tunis
                         }
                         case PathCommandType::quadraticCurveTo:
                         {
-                            if (path.subPathCount() == 0) { id = addSubPath(path, glm::vec2(0.0f)); }
+                            if (subPaths.size() == 0) { id = addSubPath(subPaths, glm::vec2(0.0f)); }
                             auto &points = subPaths[id].points;
                             auto &prevPoint = points.pos(points.size()-1);
                             float x0 = prevPoint.x;
@@ -1212,7 +1544,7 @@ namespace tunis
                             break;
                         }
                         case PathCommandType::arc:
-                            if (path.subPathCount() == 0) { id = addSubPath(path); }
+                            if (subPaths.size() == 0) { id = subPaths.add(); }
                             arc(subPaths[id].points,
                                 glm::vec2(commands.param0(i),
                                           commands.param1(i)),
@@ -1223,7 +1555,7 @@ namespace tunis
                             break;
                         case PathCommandType::arcTo:
                         {
-                            if (path.subPathCount() == 0) { id = addSubPath(path, glm::vec2(0.0f)); }
+                            if (subPaths.size() == 0) { id = addSubPath(subPaths, glm::vec2(0.0f)); }
                             auto &points = subPaths[id].points;
                             auto &prevPoint = points.pos(points.size()-1);
                             arcTo(subPaths[id].points,
@@ -1244,7 +1576,7 @@ namespace tunis
                             float y = commands.param1(i);
                             float w = commands.param2(i);
                             float h = commands.param3(i);
-                            id = addSubPath(path);
+                            id = subPaths.add();
                             auto &points = subPaths[id].points;
                             addPoint(points, glm::vec2(x, y), PointProperties::corner);
                             addPoint(points, glm::vec2(x, y+h), PointProperties::corner);
@@ -1257,7 +1589,7 @@ namespace tunis
                 }
 
                 // validate.
-                for (size_t id = 0; id < path.subPathCount(); ++id)
+                for (size_t id = 0; id < subPaths.size(); ++id)
                 {
                     auto &points = subPaths[id].points;
 
@@ -1266,7 +1598,7 @@ namespace tunis
                     if (points.size() >= 2 &&
                         glm::all(glm::epsilonEqual(points.pos(0),
                                                    points.pos(points.size()-1),
-                                                   distTol)))
+                                                   pathTolerance().dist)))
                     {
                         points.resize(points.size()-1);
                         subPaths[id].closed = true;
@@ -1274,12 +1606,12 @@ namespace tunis
                 }
             }
 
-            inline void calculateSegmentDirection(Path2D &path)
+            inline void calculateSegmentDirection(SubPath2DArena &subPaths)
             {
                 // Calculate direction vectors for each points of each subpaths
-                for(size_t id = 0; id < path.subPathCount(); ++id)
+                for(size_t id = 0; id < subPaths.size(); ++id)
                 {
-                    SubPath2D &subPath = path.subPaths()[id];
+                    SubPath2D &subPath = subPaths[id];
 
                     size_t p0, p1;
 
@@ -1313,18 +1645,17 @@ namespace tunis
                 }
             }
 
-            inline void generateStrokeContour(Path2D &path, const ContextState& state)
+            inline void generateStrokeContour(Path2D &path, const ContextState& state, SubPath2DArena &subPaths)
             {
-                generateContour(path);
+                generateContour(path, subPaths);
 
                 #if defined(TUNIS_PROFILING)
                 EASY_FUNCTION(profiler::colors::DarkGreen);
                 #endif
 
                 float halfLineWidth = state.lineWidth * 0.5f;
-                SubPath2DArray &subPaths = path.subPaths();
 
-                calculateSegmentDirection(path);
+                calculateSegmentDirection(subPaths);
 
                 // if we have dash lines, we split our subpath into multiple
                 // subpaths since linecaps and lineJoin rules apply to
@@ -1336,16 +1667,15 @@ namespace tunis
                     float currentOffset;
                     size_t id = 0, lineDashId;
 
-                    // TODO figure out a way to do this without causing allocation
-                    SubPath2DArray origSubPath = path.subPaths();
-                    size_t origSubPathCount = path.subPathCount();
-                    path.subPathCount() = 0;
+                    // the dashes are generated from the original sub-paths,
+                    // which remain readable with previous().
+                    size_t origSubPathCount = subPaths.rebuild();
 
                     for (size_t origId = 0; origId < origSubPathCount; ++origId)
                     {
-                        auto &origPoints = origSubPath[origId].points;
+                        auto &origPoints = subPaths.previous(origId).points;
 
-                        if (origSubPath[origId].closed)
+                        if (subPaths.previous(origId).closed)
                         {
                             p0 = origPoints.size() - 1;
                             p1 = 0;
@@ -1365,7 +1695,7 @@ namespace tunis
                             // fast foward negative offset to the nearest to zero dash bound.
                             // It should remain negative to be able to create a truncated
                             // starting dash (truncated using glm::clamp below)
-                            while (currentOffset + state.lineDashes[lineDashId] <= distTol)
+                            while (currentOffset + state.lineDashes[lineDashId] <= pathTolerance().dist)
                             {
                                 currentOffset += state.lineDashes[lineDashId];
                                 if (++lineDashId == state.lineDashes.size())
@@ -1381,9 +1711,9 @@ namespace tunis
                                     // If this statement is true, this most likely because we reached the end
                                     // of the line while having an unfinished dash line at the end of it.
                                     // We just adding one last point to finish and truncate the final dash.
-                                    if (path.subPathCount() > 0 && path.subPaths()[id].points.size() == 1)
+                                    if (subPaths.size() > 0 && subPaths[id].points.size() == 1)
                                     {
-                                        addPoint(path.subPaths()[id].points, origPoints.pos(p1), PointProperties::corner);
+                                        addPoint(subPaths[id].points, origPoints.pos(p1), PointProperties::corner);
                                     }
                                     break;
                                 }
@@ -1394,16 +1724,16 @@ namespace tunis
                                 {
                                     case 0: // Dash Start
 
-                                        id = addSubPath(path, origPoints.pos(p0) + offset);
+                                        id = addSubPath(subPaths, origPoints.pos(p0) + offset);
                                         break;
 
                                     case 1: // Dash End
 
                                         // because of the fast forwarding above it's possible to be starting
                                         // on a dash gap. If that is the case, we must not add any points.
-                                        if (path.subPathCount() > 0 && path.subPaths()[id].points.size() == 1)
+                                        if (subPaths.size() > 0 && subPaths[id].points.size() == 1)
                                         {
-                                            addPoint(path.subPaths()[id].points, origPoints.pos(p0) + offset, PointProperties::corner);
+                                            addPoint(subPaths[id].points, origPoints.pos(p0) + offset, PointProperties::corner);
                                         }
                                         break;
                                 }
@@ -1420,10 +1750,10 @@ namespace tunis
                         }
                     }
 
-                    calculateSegmentDirection(path);
+                    calculateSegmentDirection(subPaths);
                 }
 
-                for (size_t id = 0; id < path.subPathCount(); ++id)
+                for (size_t id = 0; id < subPaths.size(); ++id)
                 {
                     auto &points = subPaths[id].points;
                     auto &outerPoints = subPaths[id].outerPoints;
@@ -1742,26 +2072,65 @@ namespace tunis
                 }
             }
 
-            inline void triangulate(Path2D &path)
+            /*!
+             * \brief triangulate triangulates the sub-paths of path one at a
+             * time in the working memory of the arena, and appends each of
+             * them to mesh.
+             */
+            inline void triangulate(Path2D &path, SubPath2DArena &subPaths, Mesh &mesh)
             {
                 #if defined(TUNIS_PROFILING)
                 EASY_FUNCTION(profiler::colors::DarkBlue);
                 #endif
 
-                SubPath2DArray &subPaths = path.subPaths();
                 glm::vec2 &boundTopLeft = path.boundTopLeft();
                 glm::vec2 &boundBottomRight = path.boundBottomRight();
                 boundTopLeft = glm::vec2(FLT_MAX);
                 boundBottomRight = glm::vec2(-FLT_MAX);
 
-                for (size_t id = 0; id < path.subPathCount(); ++id)
+                mesh.clear();
+
+                for (size_t id = 0; id < subPaths.size(); ++id)
                 {
-                    MPEPolyContext &polyContext = subPaths[id].polyContext;
-                    MemPool &mempool = subPaths[id].mempool;
+                    MPEPolyContext &polyContext = subPaths.polyContext;
                     auto &points = subPaths[id].points;
                     auto &innerPoints = subPaths[id].innerPoints;
                     auto &outerPoints = subPaths[id].outerPoints;
 
+#if TUNIS_CONVEX_FAST_PATH
+                    // Convex outlines without holes, such as rects, are
+                    // fanned out directly instead of going through poly2tri.
+                    const glm::vec2 *outline = nullptr;
+                    size_t outlineSize = 0;
+                    if (outerPoints.size() >= 3)
+                    {
+                        if (innerPoints.size() < 3)
+                        {
+                            outline = outerPoints.data();
+                            outlineSize = outerPoints.size();
+                        }
+                    }
+                    else if (points.size() >= 3)
+                    {
+                        outline = &points.pos(0);
+                        outlineSize = points.size();
+                    }
+
+                    float area;
+                    if (outline && isConvex(outline, outlineSize, area))
+                    {
+                        for(size_t j = 0; j < outlineSize; ++j)
+                        {
+                            // update path bounds
+                            boundTopLeft     = glm::min(boundTopLeft,     outline[j]);
+                            boundBottomRight = glm::max(boundBottomRight, outline[j]);
+                        }
+
+                        appendFan(outline, outlineSize, area, mesh);
+                        continue;
+                    }
+#endif
+
                     // The maximum number of points you expect to need
                     // This value is used by the library to calculate
                     // working memory required
@@ -1771,13 +2140,13 @@ namespace tunis
                     // allocate for the library
                     size_t memoryRequired = MPE_PolyMemoryRequired(maxPointCount);
 
-                    // Allocate a memory block of size MemoryRequired
-                    // IMPORTANT: The memory must be zero initialized
-                    mempool.resize(memoryRequired, 0);
+                    // Get a zero initialized memory block of size
+                    // MemoryRequired, reused from one sub-path to the next.
+                    void *memory = subPaths.polyMemory(memoryRequired);
 
                     // Initialize the poly context by passing the memory pointer,
                     // and max number of points from before
-                    MPE_PolyInitContext(&polyContext, mempool.data(), maxPointCount);
+                    MPE_PolyInitContext(&polyContext, memory, maxPointCount);
 
 
                     if (outerPoints.size() >= 3)
@@ -1833,263 +2202,1733 @@ namespace tunis
                     }
 
                     MPE_PolyTriangulate(&polyContext);
+
+                    appendSubMesh(polyContext, mesh);
                 }
+
+                mesh.boundTopLeft = boundTopLeft;
+                mesh.boundBottomRight = boundBottomRight;
             }
 
-            inline const Font* findFont(const FontDef &fontDef)
+            /*!
+             * \brief fanOut appends every sub-path of path to mesh as a
+             * triangle fan around its first point, keeping the direction of
+             * its outline. The fans overlap wherever the outline is concave or
+             * crosses itself, so the mesh is only meant for the stencil pass of
+             * a stencil-then-cover fill, which counts the windings.
+             */
+            inline void fanOut(Path2D &path, SubPath2DArena &subPaths, Mesh &mesh)
             {
-                assert(fontRepo != nullptr);
+                #if defined(TUNIS_PROFILING)
+                EASY_FUNCTION(profiler::colors::DarkBlue);
+                #endif
 
-                const Font *font = nullptr;
-                for (flatbuffers::uoffset_t i = 0; i < fontRepo->fonts()->size(); ++i)
-                {
-                   const Font *candidate = fontRepo->fonts()->Get(i);
+                glm::vec2 &boundTopLeft = path.boundTopLeft();
+                glm::vec2 &boundBottomRight = path.boundBottomRight();
+                boundTopLeft = glm::vec2(FLT_MAX);
+                boundBottomRight = glm::vec2(-FLT_MAX);
 
-                    if (candidate->family()->str() == fontDef.family)
-                    {
-                        font = candidate;
+                mesh.clear();
 
-                        if (candidate->weight() == fontDef.weight && candidate->italic() == fontDef.italic)
-                        {
-                            break; // perfect candidate!
-                        }
+                for (size_t id = 0; id < subPaths.size(); ++id)
+                {
+                    auto &points = subPaths[id].points;
+                    if (points.size() < 3)
+                    {
+                        continue; // not enough points to make a fill. Skip
                     }
-                    else if (!font && candidate->weight() <= fontDef.weight && candidate->italic() == fontDef.italic)
+
+                    for(size_t j = 0; j < points.size(); ++j)
                     {
-                        font = candidate;
+                        // update path bounds
+                        boundTopLeft     = glm::min(boundTopLeft,     points.pos(j));
+                        boundBottomRight = glm::max(boundBottomRight, points.pos(j));
                     }
-                }
 
-                return font;
-            }
+                    // a zero area keeps the fan in the order of the outline.
+                    appendFan(&points.pos(0), points.size(), 0.0f, mesh);
+                }
 
-            inline const Glyph *findGlyph(const Font *font, uint32_t unicode)
-            {
-                return font->glyphs()->LookupByKey(unicode);
+                mesh.boundTopLeft = boundTopLeft;
+                mesh.boundBottomRight = boundBottomRight;
             }
 
-            inline Image getImageForGlyph(const Glyph *glyph)
+            /*!
+             * \brief internState returns the index of state in drawStates.
+             * Consecutive draws sharing the same state share the same slot.
+             */
+            inline uint32_t internState(const ContextState &state)
             {
-                auto it = fontGlyphImageCache.find(glyph);
-                if (it != fontGlyphImageCache.end())
+                if (drawStateCount > 0 && sameState(drawStates[drawStateCount-1], state))
                 {
-                    return it->second;
+                    return static_cast<uint32_t>(drawStateCount-1);
                 }
 
-                // TODO create the image and add it to the cache.
-                return Image();
+                if (drawStateCount < drawStates.size())
+                {
+                    // copy-assigning reuses the capacity of the slot's vector
+                    // and string, so this does not allocate once warmed up.
+                    drawStates[drawStateCount] = state;
+                }
+                else
+                {
+                    drawStates.push_back(state);
+                }
 
+                return static_cast<uint32_t>(drawStateCount++);
             }
-        };
-
-
-    }
-
-    Context::Context() :
-        ctx(new detail::ContextPriv())
-    {
-    }
-
-    Context::~Context()
-    {
-    }
-
-    const char * Context::backendName() const
-    {
-        return "GL";
-    }
-
-    void Context::clearFrame(int32_t fbLeft, int32_t fbTop, int32_t fbWidth, int32_t fbHeight, Color backgroundColor)
-    {
-        ctx->clearFrame(std::move(fbLeft), std::move(fbTop),
-                        std::move(fbWidth), std::move(fbHeight),
-                        std::move(backgroundColor));
-    }
-
-    void Context::beginFrame(int32_t winWidth, int32_t winHeight, float devicePixelRatio)
-    {
-        ctx->beginFrame(std::move(winWidth), std::move(winHeight), std::move(devicePixelRatio));
-    }
-
-    void Context::endFrame()
-    {
-        ctx->endFrame();
-    }
 
-    void Context::save()
-    {
-        ctx->states.push_back(*this);
-    }
+            static inline bool sameState(const ContextState &a, const ContextState &b)
+            {
+                return a.currentTransform == b.currentTransform &&
+                       a.strokeStyle.getId() == b.strokeStyle.getId() &&
+                       a.fillStyle.getId() == b.fillStyle.getId() &&
+                       a.globalAlpha == b.globalAlpha &&
+                       a.lineWidth == b.lineWidth &&
+                       a.lineCap == b.lineCap &&
+                       a.lineJoin == b.lineJoin &&
+                       a.miterLimit == b.miterLimit &&
+                       a.lineDashOffset == b.lineDashOffset &&
+                       a.shadowOffsetX == b.shadowOffsetX &&
+                       a.shadowOffsetY == b.shadowOffsetY &&
+                       a.shadowBlur == b.shadowBlur &&
+                       a.shadowColor == b.shadowColor &&
+                       a.globalCompositeOperation == b.globalCompositeOperation &&
+                       a.font.fontSize == b.font.fontSize &&
+                       a.font.weight == b.font.weight &&
+                       a.font.italic == b.font.italic &&
+                       a.font.family == b.font.family &&
+                       a.textAlign == b.textAlign &&
+                       a.textBaseline == b.textBaseline &&
+                       a.direction == b.direction &&
+                       a.imageSmoothingEnabled == b.imageSmoothingEnabled &&
+                       a.clipRegion.getId() == b.clipRegion.getId() &&
+                       a.lineDashes == b.lineDashes;
+            }
 
-    void Context::restore()
-    {
-        if (ctx->states.size() > 0)
-        {
-            *static_cast<ContextState*>(this) = ctx->states.back();
-            ctx->states.pop_back();
-        }
-    }
+            /*!
+             * \brief tessellationKey hashes everything the tessellation of a
+             * draw depends on: its path commands, the tolerances, the scale of
+             * its transform and, for strokes, the line style. Paints, shadows
+             * and the rest of the transform are applied while batching, so
+             * they are not part of the key. Instanced fills share the meshes
+             * of the plain ones.
+             */
+            inline Hash tessellationKey(DrawOp op, Path2D &path, float scale, const ContextState &state) const
+            {
+                Hash hash;
+                hash.add(op == DRAW_FILL_INSTANCED ? DRAW_FILL : op);
+                hash.add(tessTol);
+                hash.add(distTol);
+                hash.add(scale);
 
-    void Context::clearRect(float x, float y, float width, float height)
-    {
-        Paint origFillStyle = fillStyle;
-        fillStyle = detail::gfxStates.backgroundColor;
-        rect(x, y, width, height);
-        fill();
-        fillStyle = origFillStyle;
-    }
+                const PathCommandArray &commands = path.commands();
+                for (size_t i = 0; i < commands.size(); ++i)
+                {
+                    hash.add(commands.type(i));
+                    hash.add(commands.param0(i));
+                    hash.add(commands.param1(i));
+                    hash.add(commands.param2(i));
+                    hash.add(commands.param3(i));
+                    hash.add(commands.param4(i));
+                    hash.add(commands.param5(i));
+                    hash.add(commands.param6(i));
+                    hash.add(commands.param7(i));
+                }
 
-    void Context::fillText(const char *text, float x, float y, float maxWidth)
-    {
-        if (ctx->fontRepo == nullptr)
-        {
-            std::cout << "No font repository loaded. Missing fonts.tfp?" << std::endl;
-            return;
-        }
+                if (op == DRAW_STROKE)
+                {
+                    hash.add(state.lineWidth);
+                    hash.add(state.lineCap);
+                    hash.add(state.lineJoin);
+                    hash.add(state.miterLimit);
+                    if (state.lineDashes.size() > 0)
+                    {
+                        hash.add(state.lineDashOffset);
+                        hash.add(state.lineDashes.data(), state.lineDashes.size() * sizeof(float));
+                    }
+                }
 
-        const Font *inst = ctx->findFont(font);
-        if (!inst)
-        {
-            std::cout << "Could not find suitable font candidate for " << font.family << std::endl;
-            return;
-        }
+                return hash;
+            }
 
-        for(size_t i = 0; i < strlen(text); ++i)
-        {
-            const Glyph *glyph = ctx->findGlyph(inst, static_cast<uint32_t>(text[i]));
-            if (glyph)
+            static inline bool hasShadow(const ContextState &state)
             {
-                Image glyphImage = ctx->getImageForGlyph(glyph);
+                return state.shadowColor != Transparent &&
+                       (glm::epsilonNotEqual(state.shadowOffsetX, 0.0f, glm::epsilon<float>()) ||
+                        glm::epsilonNotEqual(state.shadowOffsetY, 0.0f, glm::epsilon<float>()));
             }
-        }
-    }
 
-    void Context::strokeText(const char *text, float x, float y, float maxWidth)
-    {
+            /*!
+             * \brief sortKey returns the key of a draw: draws with the same
+             * key end up in the same batch when they are batched one after the
+             * other. Stencil-then-cover and instanced fills never share their
+             * batches, so they get UniqueSortKey.
+             */
+            inline uint64_t sortKey(size_t i)
+            {
+                if (renderQueue.op(i) == DRAW_FILL_STENCIL || renderQueue.op(i) == DRAW_FILL_INSTANCED)
+                {
+                    return UniqueSortKey;
+                }
 
-    }
+                if (renderQueue.op(i) == DRAW_TEXT_FILL || renderQueue.op(i) == DRAW_TEXT_STROKE)
+                {
+                    // the msdf program only depends on the atlas page of the
+                    // glyphs, most likely the one of the first glyph.
+                    if (renderQueue.instanceCount(i) == 0)
+                    {
+                        return TextSortKey;
+                    }
 
-    void Context::fill(Path2D &path, FillRule /*fillRule*/)
-    {
-        ctx->renderQueue.push(detail::DRAW_FILL,
-                              path.clone<Path2D>(),
-                              std::move(*this));
-        path.reset();
-    }
+                    auto it = fontGlyphImageCache.find(glyphQuads.glyph(renderQueue.instanceStart(i)));
+                    if (it == fontGlyphImageCache.end() || !it->second.parent())
+                    {
+                        return TextSortKey;
+                    }
 
-    void Context::stroke(Path2D &path)
-    {
-        ctx->renderQueue.push(detail::DRAW_STROKE,
-                              path.clone<Path2D>(),
-                              std::move(*this));
-        path.reset();
-    }
+                    return TextSortKey | pageIndex(it->second.parent());
+                }
 
-    void Image::sourceChanged(detail::ContextPriv *ctx)
-    {
-        auto decodeTask = +[](Image *self, std::string url)->void
-        {
-            #if defined(TUNIS_PROFILING)
-            EASY_THREAD_SCOPE(url);
-            EASY_FUNCTION();
-            #endif
+                const ContextState &state = drawStates[renderQueue.stateId(i)];
+                const Paint &paint = renderQueue.op(i) == DRAW_STROKE ? state.strokeStyle : state.fillStyle;
 
-            int w, h, n;
-            uint8_t *raw = stbi_load(url.c_str(), &w, &h, &n, 4); // force RGBA
+                switch (paint.type())
+                {
+                    case PaintType::texture:
+                        // the texture program only depends on the atlas page.
+                        return paint.image().parent() ? pageIndex(paint.image().parent()) : 0;
+                    case PaintType::gradientLinear:
+                    case PaintType::gradientRadial:
+                        // the gradients are read per vertex, only the program matters.
+                        return static_cast<uint64_t>(paint.type()) << 32;
+                }
 
-            if (!raw)
-            {
-                fprintf(stderr, "Could not load %s : %s\n", url.c_str(), stbi_failure_reason());
-                return;
+                return UniqueSortKey;
             }
 
-            int pw = w + detail::gfxStates.texPadding + detail::gfxStates.texPadding;
-            int ph = h + detail::gfxStates.texPadding + detail::gfxStates.texPadding;
-
-            self->data().resize(pw * ph * 4);
-
-            uint8_t *src = raw;
-            uint8_t *dst = self->data().data();
-
-            for(int row = 0; row < detail::gfxStates.texPadding; ++row)
+            /*!
+             * \brief drawBounds returns the device space bounds of what a draw
+             * touches, shadow included.
+             */
+            inline void drawBounds(size_t i, glm::vec2 &boundTopLeft, glm::vec2 &boundBottomRight)
             {
-                for(size_t col = 0; col < detail::gfxStates.texPadding; ++col)
+                const Mesh &mesh = *renderQueue.mesh(i);
+                const ContextState &state = drawStates[renderQueue.stateId(i)];
+
+                if (renderQueue.op(i) == DRAW_FILL_INSTANCED)
                 {
-                    memcpy(dst, &Red, 4);
-                    dst+=4;
+                    // the instances may be anywhere.
+                    boundTopLeft = glm::vec2(-FLT_MAX);
+                    boundBottomRight = glm::vec2(FLT_MAX);
+                    return;
                 }
 
-                memcpy(dst, src, w*4);
-                dst+=(w*4);
+                boundTopLeft = glm::vec2(FLT_MAX);
+                boundBottomRight = glm::vec2(-FLT_MAX);
+
+                glm::vec2 topLeft = mesh.boundTopLeft;
+                glm::vec2 bottomRight = mesh.boundBottomRight;
 
-                for(size_t col = 0; col < detail::gfxStates.texPadding; ++col)
+                if (renderQueue.op(i) == DRAW_TEXT_FILL || renderQueue.op(i) == DRAW_TEXT_STROKE)
                 {
-                    memcpy(dst, &Lime, 4);
-                    dst+=4;
-                }
-            }
+                    if (renderQueue.instanceCount(i) == 0)
+                    {
+                        return; // draws nothing, overlaps nothing.
+                    }
 
-            for(int row = 0; row < h; ++row)
-            {
-                for(size_t col = 0; col < detail::gfxStates.texPadding; ++col)
+                    topLeft = glm::vec2(FLT_MAX);
+                    bottomRight = glm::vec2(-FLT_MAX);
+                    uint32_t end = renderQueue.instanceStart(i) + renderQueue.instanceCount(i);
+                    for (uint32_t k = renderQueue.instanceStart(i); k < end; ++k)
+                    {
+                        topLeft = glm::min(topLeft, glyphQuads.topLeft(k));
+                        bottomRight = glm::max(bottomRight, glyphQuads.bottomRight(k));
+                    }
+                }
+                else if (mesh.subMeshes.size() == 0)
                 {
-                    memcpy(dst, src, 4);
-                    dst+=4;
+                    return; // draws nothing, overlaps nothing.
                 }
 
-                memcpy(dst, src, w*4);
-                dst+=(w*4);
-                src+=((w-1)*4);
+                const SVGMatrix &transform = state.currentTransform;
+                glm::vec2 corners[4] = {
+                    topLeft,
+                    glm::vec2(bottomRight.x, topLeft.y),
+                    bottomRight,
+                    glm::vec2(topLeft.x, bottomRight.y),
+                };
 
-                for(size_t col = 0; col < detail::gfxStates.texPadding; ++col)
+                for (size_t c = 0; c < 4; ++c)
                 {
-                    memcpy(dst, src, 4);
-                    dst+=4;
+                    glm::vec2 corner(glm::dot(transform[0], glm::vec3(corners[c], 1.0f)),
+                                     glm::dot(transform[1], glm::vec3(corners[c], 1.0f)));
+                    boundTopLeft = glm::min(boundTopLeft, corner);
+                    boundBottomRight = glm::max(boundBottomRight, corner);
                 }
 
-                src+=(4);
+                if (hasShadow(state))
+                {
+                    glm::vec2 shadowOffset(state.shadowOffsetX, state.shadowOffsetY);
+                    boundTopLeft = glm::min(boundTopLeft, boundTopLeft + shadowOffset);
+                    boundBottomRight = glm::max(boundBottomRight, boundBottomRight + shadowOffset);
+                }
             }
 
-            src-=(w*4);
-
-            for(int row = 0; row < detail::gfxStates.texPadding; ++row)
+            /*!
+             * \brief reorderDraws fills drawOrder with the draws of the render
+             * queue, moving each draw back next to the last draws sharing its
+             * sort key, when it overlaps none of the draws it jumps over.
+             * Overlapping draws keep the painter's order. At most
+             * TUNIS_REORDER_WINDOW runs of draws are looked back.
+             */
+            inline void reorderDraws()
             {
-                for(size_t col = 0; col < detail::gfxStates.texPadding; ++col)
-                {
-                    memcpy(dst, &White, 4);
-                    dst+=4;
-                }
+                #if defined(TUNIS_PROFILING)
+                EASY_FUNCTION(profiler::colors::DarkRed);
+                #endif
 
-                memcpy(dst, src, w*4);
-                dst+=(w*4);
+                drawBuckets.resize(0);
+                drawNext.resize(renderQueue.size());
 
-                for(size_t col = 0; col < detail::gfxStates.texPadding; ++col)
+                size_t keyRunsBefore = 0;
+                uint64_t previousKey = UniqueSortKey;
+
+                for (size_t i = 0; i < renderQueue.size(); ++i)
                 {
-                    memcpy(dst, &Blue, 4);
-                    dst+=4;
-                }
-            }
+                    uint64_t key = sortKey(i);
+                    glm::vec2 boundTopLeft, boundBottomRight;
+                    drawBounds(i, boundTopLeft, boundBottomRight);
 
-            stbi_image_free(raw);
-            self->bounds().setWidth(w);
-            self->bounds().setHeight(h);
-            self->paddedBounds().setWidth(pw);
-            self->paddedBounds().setHeight(ph);
-            detail::enqueueTask(&Image::dataChanged, self);
-        };
+                    if (key == UniqueSortKey || key != previousKey)
+                    {
+                        ++keyRunsBefore;
+                    }
+                    previousKey = key;
 
-        std::thread(decodeTask, this, source()).detach();
-    }
+                    drawNext[i] = SIZE_MAX;
 
-    void Image::dataChanged(detail::ContextPriv *ctx)
-    {
-        for(size_t i = 0; i < ctx->textures.size(); ++i)
-        {
-            if (ctx->textures[i]->tryAddImage(*this))
-            {
-                break;
-            }
-        }
+                    size_t target = SIZE_MAX;
+                    if (key != UniqueSortKey)
+                    {
+                        size_t window = 0;
+                        for (size_t b = drawBuckets.size(); b > 0 && window < TUNIS_REORDER_WINDOW; --b, ++window)
+                        {
+                            DrawBucket &bucket = drawBuckets[b - 1];
+                            if (bucket.key == key)
+                            {
+                                target = b - 1;
+                                break;
+                            }
+
+                            if (glm::all(glm::lessThanEqual(bucket.boundTopLeft, boundBottomRight)) &&
+                                glm::all(glm::lessThanEqual(boundTopLeft, bucket.boundBottomRight)))
+                            {
+                                break; // cannot be drawn before this bucket.
+                            }
+                        }
+                    }
+
+                    if (target == SIZE_MAX)
+                    {
+                        drawBuckets.push_back({key, boundTopLeft, boundBottomRight, i, i});
+                    }
+                    else
+                    {
+                        DrawBucket &bucket = drawBuckets[target];
+                        bucket.boundTopLeft = glm::min(bucket.boundTopLeft, boundTopLeft);
+                        bucket.boundBottomRight = glm::max(bucket.boundBottomRight, boundBottomRight);
+                        drawNext[bucket.tail] = i;
+                        bucket.tail = i;
+                    }
+                }
+
+                drawOrder.resize(0);
+                for (size_t b = 0; b < drawBuckets.size(); ++b)
+                {
+                    for (size_t i = drawBuckets[b].head; i != SIZE_MAX; i = drawNext[i])
+                    {
+                        drawOrder.push_back(i);
+                    }
+                }
+
+                // neighbouring buckets never share their key, so every bucket
+                // is a run of the same key now.
+                keyRunsUnsorted = keyRunsBefore;
+                keyRunsSorted = drawBuckets.size();
+            }
+
+            /*!
+             * \brief tessellationScale returns how much transform enlarges
+             * the paths, rounded up to a quarter power of two so that smooth
+             * zooms keep hitting the tessellation cache.
+             */
+            static inline float tessellationScale(const SVGMatrix &transform)
+            {
+                float sx = glm::length(glm::vec2(transform[0].x, transform[1].x));
+                float sy = glm::length(glm::vec2(transform[0].y, transform[1].y));
+                float scale = glm::max(sx, sy);
+
+                if (!(scale > 0.0f) || glm::isinf(scale))
+                {
+                    return 1.0f; // degenerate transform, nothing will show.
+                }
+
+                return glm::exp2(glm::ceil(glm::log2(scale) * 4.0f) / 4.0f);
+            }
+
+            /*!
+             * \brief multiply returns the transform applying b, then a.
+             */
+            static inline SVGMatrix multiply(const SVGMatrix &a, const SVGMatrix &b)
+            {
+                SVGMatrix result;
+                for (int row = 0; row < 2; ++row)
+                {
+                    result[row] = glm::vec3(a[row].x * b[0].x + a[row].y * b[1].x,
+                                            a[row].x * b[0].y + a[row].y * b[1].y,
+                                            a[row].x * b[0].z + a[row].y * b[1].z + a[row].z);
+                }
+                return result;
+            }
+
+            /*!
+             * \brief tessellationCost estimates how long tessellating a draw
+             * takes, in arbitrary units, from its commands alone. Curves are
+             * flattened into many points, and stroke joins, caps and dashes
+             * multiply the points of the outline.
+             */
+            inline float tessellationCost(DrawOp op, Path2D &path, const ContextState &state) const
+            {
+                const PathCommandArray &commands = path.commands();
+
+                float pointCount = 0.0f;
+                float length = 0.0f;
+                glm::vec2 pos(0.0f);
+
+                for (size_t i = 0; i < commands.size(); ++i)
+                {
+                    switch(commands.type(i))
+                    {
+                        case PathCommandType::close:
+                            break;
+                        case PathCommandType::moveTo:
+                            pointCount += 1.0f;
+                            pos = glm::vec2(commands.param0(i), commands.param1(i));
+                            break;
+                        case PathCommandType::lineTo:
+                        {
+                            glm::vec2 end(commands.param0(i), commands.param1(i));
+                            pointCount += 1.0f;
+                            length += glm::distance(pos, end);
+                            pos = end;
+                            break;
+                        }
+                        case PathCommandType::bezierCurveTo:
+                        {
+                            glm::vec2 end(commands.param4(i), commands.param5(i));
+                            pointCount += 16.0f;
+                            length += glm::distance(pos, glm::vec2(commands.param0(i), commands.param1(i))) +
+                                      glm::distance(glm::vec2(commands.param0(i), commands.param1(i)), glm::vec2(commands.param2(i), commands.param3(i))) +
+                                      glm::distance(glm::vec2(commands.param2(i), commands.param3(i)), end);
+                            pos = end;
+                            break;
+                        }
+                        case PathCommandType::quadraticCurveTo:
+                        {
+                            glm::vec2 end(commands.param2(i), commands.param3(i));
+                            pointCount += 16.0f;
+                            length += glm::distance(pos, glm::vec2(commands.param0(i), commands.param1(i))) +
+                                      glm::distance(glm::vec2(commands.param0(i), commands.param1(i)), end);
+                            pos = end;
+                            break;
+                        }
+                        case PathCommandType::arc:
+                        {
+                            float radius = commands.param2(i);
+                            float sweep = glm::min(glm::abs(commands.param4(i) - commands.param3(i)), Math::PI * 2.0f);
+                            pointCount += 16.0f;
+                            length += radius * sweep;
+                            pos = glm::vec2(commands.param0(i) + radius * glm::cos(commands.param4(i)),
+                                            commands.param1(i) + radius * glm::sin(commands.param4(i)));
+                            break;
+                        }
+                        case PathCommandType::arcTo:
+                        {
+                            glm::vec2 end(commands.param2(i), commands.param3(i));
+                            pointCount += 16.0f;
+                            length += glm::distance(pos, glm::vec2(commands.param0(i), commands.param1(i))) +
+                                      glm::distance(glm::vec2(commands.param0(i), commands.param1(i)), end);
+                            pos = end;
+                            break;
+                        }
+                        case PathCommandType::ellipse:
+                            pointCount += 16.0f;
+                            break;
+                        case PathCommandType::rect:
+                            pointCount += 4.0f;
+                            length += 2.0f * (glm::abs(commands.param2(i)) + glm::abs(commands.param3(i)));
+                            pos = glm::vec2(commands.param0(i), commands.param1(i));
+                            break;
+                    }
+                }
+
+                if (op == DRAW_STROKE)
+                {
+                    // every point gets an inner and outer offset, and round
+                    // joins and caps emit a fan of points of their own.
+                    float pointCost = state.lineJoin == LineJoin::round ? 8.0f : 2.0f;
+
+                    if (state.lineDashes.size() > 0)
+                    {
+                        float patternLength = 0.0f;
+                        for (size_t i = 0; i < state.lineDashes.size(); ++i)
+                        {
+                            patternLength += state.lineDashes[i];
+                        }
+
+                        if (patternLength > distTol)
+                        {
+                            // every dash is a sub-path of its own, with two
+                            // caps.
+                            float dashCount = length / patternLength * state.lineDashes.size() * 0.5f;
+                            pointCount += dashCount * (state.lineCap == LineCap::round ? 16.0f : 4.0f);
+                        }
+                    }
+                    else if (state.lineCap == LineCap::round)
+                    {
+                        pointCount += 16.0f;
+                    }
+
+                    pointCount *= pointCost;
+                }
+
+                if (op == DRAW_FILL_STENCIL)
+                {
+                    // fanning out is linear.
+                    return pointCount;
+                }
+
+                // triangulation grows slightly faster than linearly.
+                return pointCount * glm::log2(pointCount + 2.0f);
+            }
+
+            /*!
+             * \brief isConvex tells whether the closed outline made of count
+             * points is a simple convex polygon, and returns twice its signed
+             * area. Every turn must go the same way, and the outline must
+             * change horizontal direction no more than twice, which rules out
+             * self-intersecting stars.
+             */
+            static inline bool isConvex(const glm::vec2 *points, size_t count, float &area)
+            {
+                float turn = 0.0f;
+                float firstDx = 0.0f;
+                float lastDx = 0.0f;
+                size_t dxFlips = 0;
+
+                area = 0.0f;
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const glm::vec2 &p0 = points[i];
+                    const glm::vec2 &p1 = points[(i + 1) % count];
+                    const glm::vec2 &p2 = points[(i + 2) % count];
+                    glm::vec2 e0 = p1 - p0;
+                    glm::vec2 e1 = p2 - p1;
+
+                    float cross = e0.x * e1.y - e0.y * e1.x;
+                    if (cross != 0.0f)
+                    {
+                        if (turn == 0.0f)
+                        {
+                            turn = cross;
+                        }
+                        else if ((cross > 0.0f) != (turn > 0.0f))
+                        {
+                            return false;
+                        }
+                    }
+
+                    if (e0.x != 0.0f)
+                    {
+                        if (firstDx == 0.0f)
+                        {
+                            firstDx = e0.x;
+                        }
+                        else if ((e0.x > 0.0f) != (lastDx > 0.0f))
+                        {
+                            ++dxFlips;
+                        }
+                        lastDx = e0.x;
+                    }
+
+                    area += p0.x * p1.y - p1.x * p0.y;
+                }
+
+                if (firstDx != 0.0f && (firstDx > 0.0f) != (lastDx > 0.0f))
+                {
+                    ++dxFlips;
+                }
+
+                return dxFlips <= 2 && area != 0.0f;
+            }
+
+            /*!
+             * \brief appendFan appends a convex outline to mesh as a triangle
+             * fan, wound like the flipped poly2tri output of appendSubMesh.
+             */
+            inline void appendFan(const glm::vec2 *points, size_t count, float area, Mesh &mesh)
+            {
+                if (count > MaxBatchVertexCount)
+                {
+                    fprintf(stderr, "Sub-path of %zu vertices exceeds the index range. Skipped.\n", count);
+                    return;
+                }
+
+                uint32_t vertexCount = static_cast<uint32_t>(count);
+                uint32_t indexCount = static_cast<uint32_t>((count - 2) * 3);
+
+                mesh.subMeshes.push(static_cast<uint32_t>(mesh.vertices.size()),
+                                    std::move(vertexCount),
+                                    static_cast<uint32_t>(mesh.indices.size()),
+                                    std::move(indexCount));
+
+                mesh.vertices.insert(mesh.vertices.end(), points, points + count);
+
+                for (size_t k = 1; k + 1 < count; ++k)
+                {
+                    Index p1 = static_cast<Index>(k);
+                    Index p2 = static_cast<Index>(k + 1);
+
+                    mesh.indices.push_back(0);
+                    if (area > 0.0f)
+                    {
+                        mesh.indices.push_back(p2);
+                        mesh.indices.push_back(p1);
+                    }
+                    else
+                    {
+                        mesh.indices.push_back(p1);
+                        mesh.indices.push_back(p2);
+                    }
+                }
+            }
+
+            /*!
+             * \brief appendSubMesh copies the triangulation held by
+             * polyContext into a new sub mesh of mesh, with the indices flipped
+             * to the winding expected by the renderer.
+             */
+            inline void appendSubMesh(const MPEPolyContext &polyContext, Mesh &mesh)
+            {
+                uint32_t vertexCount = polyContext.PointPoolCount;
+                uint32_t indexCount = polyContext.TriangleCount*3;
+
+                if (vertexCount < 3)
+                {
+                    return; // not enough vertices to make a fill. Skip
+                }
+
+                if (vertexCount > MaxBatchVertexCount)
+                {
+                    fprintf(stderr, "Sub-path of %u vertices exceeds the index range. Skipped.\n", vertexCount);
+                    return;
+                }
+
+                mesh.subMeshes.push(static_cast<uint32_t>(mesh.vertices.size()),
+                                    std::move(vertexCount),
+                                    static_cast<uint32_t>(mesh.indices.size()),
+                                    std::move(indexCount));
+
+                for (size_t vid = 0; vid < polyContext.PointPoolCount; ++vid)
+                {
+                    const MPEPolyPoint &Point = polyContext.PointsPool[vid];
+                    mesh.vertices.emplace_back(Point.X, Point.Y);
+                }
+
+                for (size_t tid = 0; tid < polyContext.TriangleCount; ++tid)
+                {
+                    const MPEPolyTriangle* triangle = polyContext.Triangles[tid];
+
+                    // get the array index by pointer address arithmetic.
+                    Index p0 = static_cast<Index>(triangle->Points[0] - polyContext.PointsPool);
+                    Index p1 = static_cast<Index>(triangle->Points[1] - polyContext.PointsPool);
+                    Index p2 = static_cast<Index>(triangle->Points[2] - polyContext.PointsPool);
+
+                    mesh.indices.push_back(p2);
+                    mesh.indices.push_back(p1);
+                    mesh.indices.push_back(p0);
+                }
+            }
+
+            /*!
+             * \brief coverQuad returns the bounding quad of mesh, wound like
+             * the fills of the renderer.
+             */
+            inline const Mesh &coverQuad(const Mesh &mesh)
+            {
+                const glm::vec2 &topLeft = mesh.boundTopLeft;
+                const glm::vec2 &bottomRight = mesh.boundBottomRight;
+                glm::vec2 corners[4] = {
+                    topLeft,
+                    glm::vec2(bottomRight.x, topLeft.y),
+                    bottomRight,
+                    glm::vec2(topLeft.x, bottomRight.y),
+                };
+                glm::vec2 size = bottomRight - topLeft;
+
+                coverMesh.clear();
+                appendFan(corners, 4, 2.0f * size.x * size.y, coverMesh);
+                coverMesh.boundTopLeft = topLeft;
+                coverMesh.boundBottomRight = bottomRight;
+                return coverMesh;
+            }
+
+            /*!
+             * \brief anyTexture returns a texture for the draws that only
+             * sample the white square, which every atlas page has: the one of
+             * the last batch, so they continue it, or the first page.
+             */
+            inline Texture *anyTexture()
+            {
+                if (batches.size() > 0 && batches.texture(batches.size() - 1))
+                {
+                    return batches.texture(batches.size() - 1);
+                }
+
+                return textures.front().get();
+            }
+
+            /*!
+             * \brief pageIndex returns the index of texture in textures.
+             */
+            inline size_t pageIndex(const Texture *texture) const
+            {
+                for (size_t i = 0; i < textures.size(); ++i)
+                {
+                    if (textures[i].get() == texture)
+                    {
+                        return i;
+                    }
+                }
+
+                return 0;
+            }
+
+            /*!
+             * \brief residentTexture returns the atlas page of an image about
+             * to be drawn, adding it back first if it was evicted, and marks it
+             * as drawn in this frame, or decoding it again if its pixels were
+             * already released. Images without pixels, the ones of the solid
+             * colors, images still loading and images that could not be
+             * decoded are drawn with the white square of any page.
+             *
+             * \param bounds set to the texels to sample.
+             */
+            inline Texture *residentTexture(const Image &drawn, Rect<int32_t> &bounds)
+            {
+                Image image = drawn;
+
+                if (!image.parent() && !image.loading())
+                {
+                    if (image.data().size() > 0)
+                    {
+                        image.loading() = addImage(image);
+                    }
+                    else if (image.source().size() > 0 && !image.failed())
+                    {
+                        // evicted, its pixels were released once uploaded.
+                        image.sourceChanged(this);
+                    }
+                }
+
+                if (image.parent())
+                {
+                    // keep its room while it uploads too.
+                    image.lastDrawnFrame() = frameIndex;
+                }
+
+                if (!image.parent() || image.loading())
+                {
+                    bounds = Rect<int32_t>(0, 0, 1, 1);
+                    return anyTexture();
+                }
+
+                bounds = image.bounds();
+                return image.parent();
+            }
+
+            /*!
+             * \brief addImage finds room for image in the atlas: in one of the
+             * pages, in a new page as long as they all fit in atlasBudget, or
+             * else in the room of the least recently drawn images. The images
+             * drawn in the current frame are never evicted, since their batches
+             * still need them. Its pixels are then queued to imageUploader.
+             *
+             * \return false if there was no room for it.
+             */
+            inline bool addImage(Image &image)
+            {
+                for (size_t i = 0; i < textures.size(); ++i)
+                {
+                    if (textures[i]->tryAddImage(image))
+                    {
+                        return uploadImage(image);
+                    }
+                }
+
+                size_t memoryUsage = 0;
+                for (size_t i = 0; i < textures.size(); ++i)
+                {
+                    memoryUsage += textures[i]->memoryUsage();
+                }
+
+                if (memoryUsage + textures.front()->memoryUsage() <= atlasBudget)
+                {
+                    textures.emplace_back(new Texture(gfxStates.maxTexSize, gfxStates.maxTexSize));
+                    if (textures.back()->tryAddImage(image))
+                    {
+                        return uploadImage(image);
+                    }
+                }
+
+                // evict the least recently drawn images one by one, until one
+                // of them leaves enough room on its page.
+                evictionOrder.resize(0);
+                for (size_t i = 0; i < textures.size(); ++i)
+                {
+                    for (size_t j = 0; j < textures[i]->imageCount(); ++j)
+                    {
+                        const Image &resident = textures[i]->image(j);
+                        if (resident.lastDrawnFrame() != frameIndex)
+                        {
+                            evictionOrder.push_back(resident);
+                        }
+                    }
+                }
+
+                std::sort(evictionOrder.begin(), evictionOrder.end(), [](const Image &a, const Image &b) {
+                    return a.lastDrawnFrame() < b.lastDrawnFrame();
+                });
+
+                for (size_t i = 0; i < evictionOrder.size(); ++i)
+                {
+                    Texture *texture = evictionOrder[i].parent();
+                    texture->removeImage(evictionOrder[i]);
+                    ++stats.atlasEvictions;
+
+                    if (texture->tryAddImage(image))
+                    {
+                        evictionOrder.resize(0);
+                        return uploadImage(image);
+                    }
+                }
+
+                evictionOrder.resize(0);
+
+                fprintf(stderr, "Image %d ('%s') does not fit in the atlas.\n",
+                        image.getId(),
+                        image.source().c_str());
+                return false;
+            }
+
+            /*!
+             * \brief uploadImage queues the pixels of image, just added to the
+             * atlas, to imageUploader. tryAddImage() also succeeds on the
+             * images it rejects, these have no parent.
+             */
+            inline bool uploadImage(Image &image)
+            {
+                if (image.parent())
+                {
+                    imageUploader->enqueue(image);
+                }
+
+                return true;
+            }
+
+            /*!
+             * \brief addStencil batches the fans of a stencil-then-cover fill,
+             * transformed then moved by offset. Only their positions matter,
+             * since the color mask is off while they are drawn.
+             */
+            inline void addStencil(const Mesh &mesh, const SVGMatrix &transform, glm::vec2 offset, FillRule fillRule)
+            {
+                BatchKind kind = fillRule == FillRule::evenodd ? BatchKind::stencilEvenOdd : BatchKind::stencilNonZero;
+
+                for(size_t id = 0; id < mesh.subMeshes.size(); ++id)
+                {
+                    uint32_t vertexCount = mesh.subMeshes.vertexCount(id);
+                    uint32_t indexCount = mesh.subMeshes.indexCount(id);
+                    const glm::vec2 *positions = &mesh.vertices[mesh.subMeshes.vertexStart(id)];
+                    const Index *triangles = &mesh.indices[mesh.subMeshes.indexStart(id)];
+
+                    VertexTexture *verticies;
+                    Index *indices;
+                    Index base = addBatch(programTexture.get(),
+                                          anyTexture(),
+                                          kind,
+                                          vertexCount,
+                                          indexCount,
+                                          &verticies,
+                                          &indices);
+
+                    glm::vec2 translation = offset;
+                    const glm::vec2 *transformed = transformPositions(positions, vertexCount, transform, translation);
+                    for (size_t vid = 0; vid < vertexCount; ++vid)
+                    {
+                        verticies[vid].a_position = transformed[vid] + translation;
+                    }
+
+                    copyIndices(triangles, indexCount, base, indices);
+                }
+            }
+
+            /*!
+             * \brief addTextureGeometry batches mesh, transformed then moved
+             * by offset, for the texture program sampling texture. The texture
+             * coordinates follow the untransformed mesh, so patterns move
+             * along.
+             */
+            inline void addTextureGeometry(const Mesh &mesh, Texture *texture, BatchKind kind, const SVGMatrix &transform, glm::vec2 offset,
+                                           glm::vec2 texscale, glm::vec2 texoffset, glm::vec2 texsize,
+                                           Color color)
+            {
+                for(size_t id = 0; id < mesh.subMeshes.size(); ++id)
+                {
+                    uint32_t vertexCount = mesh.subMeshes.vertexCount(id);
+                    uint32_t indexCount = mesh.subMeshes.indexCount(id);
+                    const glm::vec2 *positions = &mesh.vertices[mesh.subMeshes.vertexStart(id)];
+                    const Index *triangles = &mesh.indices[mesh.subMeshes.indexStart(id)];
+
+                    VertexTexture *verticies;
+                    Index *indices;
+                    Index base = addBatch(programTexture.get(),
+                                          texture,
+                                          kind,
+                                          vertexCount,
+                                          indexCount,
+                                          &verticies,
+                                          &indices);
+
+                    //populate the vertices
+                    glm::vec2 translation = offset;
+                    const glm::vec2 *transformed = transformPositions(positions, vertexCount, transform, translation);
+                    for (size_t vid = 0; vid < vertexCount; ++vid)
+                    {
+                        glm::vec2 tcoord = texscale * positions[vid];
+
+                        verticies[vid].a_position = transformed[vid] + translation;
+                        verticies[vid].a_texcoord.s = static_cast<uint16_t>(tcoord.s);
+                        verticies[vid].a_texcoord.t = static_cast<uint16_t>(tcoord.t);
+                        verticies[vid].a_texoffset.s = static_cast<uint16_t>(texoffset.s);
+                        verticies[vid].a_texoffset.t = static_cast<uint16_t>(texoffset.t);
+                        verticies[vid].a_texsize.s = static_cast<uint16_t>(texsize.s);
+                        verticies[vid].a_texsize.t = static_cast<uint16_t>(texsize.t);
+                        verticies[vid].a_color = color;
+                    }
+
+                    //populate the indicies
+                    copyIndices(triangles, indexCount, base, indices, isMirroring(transform));
+                }
+            }
+
+            /*!
+             * \brief addGradientGeometry batches mesh, transformed, for one of
+             * the gradient programs.
+             */
+            inline void addGradientGeometry(const Mesh &mesh, BatchKind kind, const SVGMatrix &transform, ShaderProgram *program, const Paint &paint)
+            {
+                float gradient = gradientTexel(paint);
+
+                for(size_t id = 0; id < mesh.subMeshes.size(); ++id)
+                {
+                    uint32_t vertexCount = mesh.subMeshes.vertexCount(id);
+                    uint32_t indexCount = mesh.subMeshes.indexCount(id);
+                    const glm::vec2 *positions = &mesh.vertices[mesh.subMeshes.vertexStart(id)];
+                    const Index *triangles = &mesh.indices[mesh.subMeshes.indexStart(id)];
+
+                    VertexGradient *verticies;
+                    Index *indices;
+                    Index base = addBatch(program,
+                                          nullptr,
+                                          kind,
+                                          vertexCount,
+                                          indexCount,
+                                          &verticies,
+                                          &indices);
+
+                    //populate the vertices
+                    glm::vec2 translation(0.0f);
+                    const glm::vec2 *transformed = transformPositions(positions, vertexCount, transform, translation);
+                    for (size_t vid = 0; vid < vertexCount; ++vid)
+                    {
+                        verticies[vid].a_position = transformed[vid] + translation;
+                        verticies[vid].a_gradient = gradient;
+                        verticies[vid].a_paintPosition = positions[vid];
+                    }
+
+                    //populate the indicies
+                    copyIndices(triangles, indexCount, base, indices, isMirroring(transform));
+                }
+            }
+
+            /*!
+             * \brief gradientTexel returns the index of the first texel of
+             * paint in the gradient data texture, appending it to the texels of
+             * the frame the first time it is used.
+             *
+             * A gradient takes two texels of parameters, the last one ending
+             * with the row of its color stops in gradientRamps. They are in
+             * user space, like the a_paintPosition of the vertices, so the
+             * gradient follows the current transform of every draw using it.
+             */
+            inline float gradientTexel(const Paint &paint)
+            {
+                auto it = gradientIndices.find(paint.getId());
+                if (it != gradientIndices.end())
+                {
+                    return it->second;
+                }
+
+                float index = static_cast<float>(gradientTexels.size());
+                gradientIndices.emplace(paint.getId(), index);
+
+                float row = static_cast<float>(gradientRamps->ramp(paint.colorStops()));
+
+                if (paint.type() == PaintType::gradientLinear)
+                {
+                    glm::vec2 start = paint.start();
+                    glm::vec2 end = paint.end();
+                    glm::vec2 dt = end - start;
+
+                    gradientTexels.emplace_back(start.x, start.y, dt.x, dt.y);
+                    gradientTexels.emplace_back(glm::dot(dt, dt), 0.0f, 0.0f, row);
+                }
+                else
+                {
+                    glm::vec2 center = paint.start();
+                    glm::vec2 focal = paint.end();
+                    glm::vec2 dt = focal - center;
+                    float dr = paint.radius().x - paint.radius().y;
+
+                    gradientTexels.emplace_back(dt.x, dt.y, focal.x, focal.y);
+                    gradientTexels.emplace_back(paint.radius().y, dr, dt.x * dt.x + dt.y * dt.y - dr * dr, row);
+                }
+
+                return index;
+            }
+
+            /*!
+             * \brief addInstances batches count copies of mesh, taking their
+             * transforms and colors from instances starting at first. With
+             * instancing, the mesh is copied once and drawn with a single
+             * instanced draw call. Otherwise, every copy is transformed on the
+             * CPU and filled with the white texel of the texture program.
+             */
+            inline void addInstances(const Mesh &mesh, const ContextState &state, uint32_t first, uint32_t count)
+            {
+                if (instancingSupported && mesh.vertices.size() <= MaxBatchVertexCount)
+                {
+                    uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+                    uint32_t indexCount = static_cast<uint32_t>(mesh.indices.size());
+
+                    VertexPosition *verticies;
+                    Index *indices;
+                    addBatch(programInstance.get(),
+                             anyTexture(),
+                             BatchKind::instances,
+                             vertexCount,
+                             indexCount,
+                             &verticies,
+                             &indices,
+                             count);
+
+                    //populate the vertices
+                    for (size_t vid = 0; vid < vertexCount; ++vid)
+                    {
+                        verticies[vid].a_position = mesh.vertices[vid];
+                    }
+
+                    //populate the indicies, rebased on the whole mesh.
+                    for(size_t id = 0; id < mesh.subMeshes.size(); ++id)
+                    {
+                        copyIndices(&mesh.indices[mesh.subMeshes.indexStart(id)],
+                                    mesh.subMeshes.indexCount(id),
+                                    static_cast<Index>(mesh.subMeshes.vertexStart(id)),
+                                    indices + mesh.subMeshes.indexStart(id));
+                    }
+
+                    //populate the instances, right after the vertices.
+                    VertexInstance *out = reinterpret_cast<VertexInstance*>(verticies + vertexCount);
+                    for (uint32_t k = 0; k < count; ++k)
+                    {
+                        Color color = instances.color(first + k);
+                        color.a = static_cast<uint8_t>(color.a * state.globalAlpha);
+
+                        out[k].a_transform0 = instances.transform(first + k)[0];
+                        out[k].a_transform1 = instances.transform(first + k)[1];
+                        out[k].a_color = color;
+                    }
+                    return;
+                }
+
+                for (uint32_t k = 0; k < count; ++k)
+                {
+                    Color color = instances.color(first + k);
+                    color.a = static_cast<uint8_t>(color.a * state.globalAlpha);
+
+                    addTextureGeometry(mesh, anyTexture(), BatchKind::triangles, instances.transform(first + k), glm::vec2(0.0f),
+                                       glm::vec2(gfxStates.pixelWidth),
+                                       glm::vec2(0.0f), glm::vec2(1.0f),
+                                       color);
+                }
+            }
+
+            /*!
+             * \brief addGlyphs batches count glyph quads of glyphQuads,
+             * starting at first, with the msdf program: each glyph is a single
+             * textured quad, so a whole screen of text sharing an atlas page
+             * goes in a single draw call. Glyphs still uploading are skipped
+             * until they are resident.
+             */
+            inline void addGlyphs(const ContextState &state, bool stroke, uint32_t first, uint32_t count)
+            {
+                const SVGMatrix &transform = state.currentTransform;
+                const Paint &paint = stroke ? state.strokeStyle : state.fillStyle;
+
+                // gradients and patterns are not sampled, the text takes the
+                // color of their first stop.
+                Color color = paint.colorStops().color(0);
+                color.a = static_cast<uint8_t>(color.a * state.globalAlpha);
+
+                // the distances of the glyphs are enlarged along with them.
+                float scale = glm::sqrt(glm::abs(transform[0].x * transform[1].y - transform[1].x * transform[0].y));
+                float strokeWidth = stroke ? glm::max(state.lineWidth * 0.5f * scale, FLT_MIN) : 0.0f;
+
+                if (hasShadow(state))
+                {
+                    Color shadowColor = state.shadowColor;
+                    shadowColor.a = static_cast<uint8_t>((shadowColor.a/255.0f * color.a/255.0f) * 0xFF);
+                    addGlyphQuads(transform, glm::vec2(state.shadowOffsetX, state.shadowOffsetY), scale, strokeWidth, shadowColor, first, count);
+                }
+
+                addGlyphQuads(transform, glm::vec2(0.0f), scale, strokeWidth, color, first, count);
+            }
+
+            inline void addGlyphQuads(const SVGMatrix &transform, glm::vec2 offset, float scale, float strokeWidth, Color color, uint32_t first, uint32_t count)
+            {
+                bool mirrored = isMirroring(transform);
+
+                for (uint32_t k = first; k < first + count; ++k)
+                {
+                    Image image = getImageForGlyph(glyphQuads.glyph(k));
+                    if (!image.parent() || image.loading())
+                    {
+                        continue;
+                    }
+
+                    const glm::vec2 &topLeft = glyphQuads.topLeft(k);
+                    const glm::vec2 &bottomRight = glyphQuads.bottomRight(k);
+                    glm::vec2 corners[4] = {
+                        topLeft,
+                        glm::vec2(bottomRight.x, topLeft.y),
+                        bottomRight,
+                        glm::vec2(topLeft.x, bottomRight.y),
+                    };
+
+                    const Rect<int32_t> &bounds = image.bounds();
+                    glm::vec2 texTopLeft = glm::vec2(bounds.x(), bounds.y()) * gfxStates.pixelWidth;
+                    glm::vec2 texBottomRight = glm::vec2(bounds.x() + bounds.width(), bounds.y() + bounds.height()) * gfxStates.pixelWidth;
+                    glm::u16vec2 texcoords[4] = {
+                        glm::u16vec2(texTopLeft),
+                        glm::u16vec2(texBottomRight.x, texTopLeft.y),
+                        glm::u16vec2(texBottomRight),
+                        glm::u16vec2(texTopLeft.x, texBottomRight.y),
+                    };
+
+                    glm::vec2 quadOffset = offset;
+                    const glm::vec2 *positions = transformPositions(corners, 4, transform, quadOffset);
+
+                    VertexGlyph *verticies;
+                    Index *indices;
+                    Index base = addBatch(programMsdf.get(),
+                                          image.parent(),
+                                          BatchKind::triangles,
+                                          4,
+                                          6,
+                                          &verticies,
+                                          &indices);
+
+                    float range = glyphQuads.range(k) * scale;
+                    for (size_t vid = 0; vid < 4; ++vid)
+                    {
+                        verticies[vid].a_position = positions[vid] + quadOffset;
+                        verticies[vid].a_texcoord = texcoords[vid];
+                        verticies[vid].a_color = color;
+                        verticies[vid].a_range = range;
+                        verticies[vid].a_stroke = strokeWidth;
+                    }
+
+                    copyIndices(QuadIndices, 6, base, indices, mirrored);
+                }
+            }
+
+            /*!
+             * \brief copyIndices copies count indices from src to dst, adding
+             * offset to them. Mirroring transforms flip the winding of the
+             * triangles, so mirrored restores it.
+             */
+            inline void copyIndices(const Index *src, uint32_t count, Index offset, Index *dst, bool mirrored = false)
+            {
+                if (mirrored)
+                {
+                    for (uint32_t i = 0; i + 2 < count; i += 3)
+                    {
+                        dst[i] = static_cast<Index>(offset + src[i + 2]);
+                        dst[i + 1] = static_cast<Index>(offset + src[i + 1]);
+                        dst[i + 2] = static_cast<Index>(offset + src[i]);
+                    }
+                    return;
+                }
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    dst[i] = static_cast<Index>(offset + src[i]);
+                }
+            }
+
+            /*!
+             * \brief transformPositions applies the linear part of transform
+             * to count positions, in a tight loop over a scratch buffer the
+             * compiler can vectorize, and returns them. The translation is
+             * added to offset instead: the callers add an offset to every
+             * vertex anyway, so pure translations cost no extra pass.
+             */
+            inline const glm::vec2 *transformPositions(const glm::vec2 *positions, size_t count, const SVGMatrix &transform, glm::vec2 &offset)
+            {
+                offset += glm::vec2(transform[0].z, transform[1].z);
+
+                float a = transform[0].x;
+                float c = transform[0].y;
+                float b = transform[1].x;
+                float d = transform[1].y;
+
+                if (a == 1.0f && b == 0.0f && c == 0.0f && d == 1.0f)
+                {
+                    return positions;
+                }
+
+                transformedPositions.resize(count);
+                glm::vec2 *transformed = transformedPositions.data();
+                for (size_t i = 0; i < count; ++i)
+                {
+                    transformed[i].x = a * positions[i].x + c * positions[i].y;
+                    transformed[i].y = b * positions[i].x + d * positions[i].y;
+                }
+
+                return transformed;
+            }
+
+            static inline bool isMirroring(const SVGMatrix &transform)
+            {
+                return transform[0].x * transform[1].y - transform[1].x * transform[0].y < 0.0f;
+            }
+
+            /*!
+             * \brief loadFonts replaces the font repository by the one at
+             * path, unless it cannot be loaded.
+             */
+            inline bool loadFonts(const std::string &path)
+            {
+                std::shared_ptr<const FontPackage> package = loadFontPackage(path);
+                if (!package)
+                {
+                    return false;
+                }
+
+                fontPackage = std::move(package);
+                fontRepo = fontPackage->repository;
+                fontCache.reset(fontRepo);
+                fontGlyphImageCache.clear();
+                textLayoutCache.clear();
+                return true;
+            }
+
+            /*!
+             * \brief getImageForGlyph returns the atlas image of a glyph with
+             * a bitmap, and marks it as drawn in this frame. Its pixels are
+             * copied from the font package the first time, and again once it
+             * was evicted, since glyphs have no source to decode from.
+             */
+            inline Image getImageForGlyph(const Glyph *glyph)
+            {
+                Image &image = fontGlyphImageCache[glyph];
+
+                if (!image.parent() && !image.loading())
+                {
+                    image.data().assign(glyph->bitmap()->data(), glyph->bitmap()->data() + glyph->bitmap()->size());
+
+                    int pw = glyph->bitmapWidth() + gfxStates.texPadding + gfxStates.texPadding;
+                    int ph = glyph->bitmapHeight() + gfxStates.texPadding + gfxStates.texPadding;
+
+                    image.bounds().setWidth(glyph->bitmapWidth());
+                    image.bounds().setHeight(glyph->bitmapHeight());
+                    image.paddedBounds().setWidth(pw);
+                    image.paddedBounds().setHeight(ph);
+                    image.loading() = addImage(image);
+                }
+
+                if (image.parent())
+                {
+                    // keep its room while it uploads too.
+                    image.lastDrawnFrame() = frameIndex;
+                }
+
+                return image;
+            }
+
+            /*!
+             * \brief textLayoutKey returns the hashes the run of text laid out
+             * with state and maxWidth is cached under in textLayoutCache.
+             */
+            static inline Hash textLayoutKey(const ContextState &state, const char *text, float maxWidth)
+            {
+                Hash hash;
+                for (const char *c = text; *c != '\0'; ++c)
+                {
+                    hash.add(*c);
+                }
+                hash.add(static_cast<char>('\0'));
+                hash.add(state.font.family.data(), state.font.family.size());
+                hash.add(state.font.weight);
+                hash.add(state.font.italic);
+                hash.add(state.font.fontSize);
+                hash.add(maxWidth);
+                hash.add(state.textAlign);
+                hash.add(state.textBaseline);
+                hash.add(state.direction);
+                return hash;
+            }
+
+            /*!
+             * \brief layoutText returns the run of text, in UTF-8, laid out
+             * with the font, alignment, baseline and direction of state, from
+             * the layout cache, or laid out now. Glyphs without a bitmap, like
+             * spaces, only advance the pen.
+             *
+             * \return nullptr without a suitable font.
+             */
+            inline const TextRun *layoutText(const ContextState &state, const char *text, float maxWidth)
+            {
+                if (fontRepo == nullptr)
+                {
+                    std::cout << "No font repository loaded. Missing " << TUNIS_FONT_PATH << "? See Context::loadFonts()." << std::endl;
+                    return nullptr;
+                }
+
+                Hash key = textLayoutKey(state, text, maxWidth);
+                const TextRun *cached = textLayoutCache.find(key.value, key.check);
+                if (cached)
+                {
+                    ++textLayoutHits;
+                    return cached;
+                }
+
+                FontFace *face = fontCache.find(state.font);
+                if (!face)
+                {
+                    std::cout << "Could not find suitable font candidate for " << state.font.family << std::endl;
+                    return nullptr;
+                }
+
+                ++textLayoutMisses;
+                TextRun *run = textLayoutCache.insert(key.value, key.check);
+                GlyphQuadArray &quads = run->quads;
+                TextMetrics &metrics = run->metrics;
+
+                const Font *font = face->font();
+                float scale = static_cast<float>(state.font.fontSize) / font->fontSize();
+                float padding = font->padding();
+
+                // lay the glyphs out on the baseline, from 0, and keep the
+                // bounds of their ink.
+                glm::vec2 inkTopLeft(FLT_MAX);
+                glm::vec2 inkBottomRight(-FLT_MAX);
+                float pen = 0.0f;
+                const char *c = text;
+                uint32_t next = *c != '\0' ? decodeUtf8(c) : 0;
+                while (next != 0)
+                {
+                    // decoded one codepoint ahead, for the kerning.
+                    uint32_t unicode = next;
+                    next = *c != '\0' ? decodeUtf8(c) : 0;
+
+                    const Glyph *glyph = face->glyph(unicode);
+                    if (!glyph)
+                    {
+                        continue;
+                    }
+
+                    if (glyph->width() > 0 && glyph->height() > 0)
+                    {
+                        glm::vec2 inkTopLeftOfGlyph(pen + glyph->xoffset(), -glyph->yoffset());
+                        inkTopLeft = glm::min(inkTopLeft, inkTopLeftOfGlyph);
+                        inkBottomRight = glm::max(inkBottomRight, inkTopLeftOfGlyph + glm::vec2(glyph->width(), glyph->height()));
+
+                        if (glyph->bitmap())
+                        {
+                            quads.push(static_cast<const Glyph*>(glyph),
+                                       inkTopLeftOfGlyph - padding,
+                                       inkTopLeftOfGlyph - padding + glm::vec2(glyph->bitmapWidth(), glyph->bitmapHeight()),
+                                       font->distanceRange());
+                        }
+                    }
+
+                    pen += glyph->xadvance() + face->kerning(unicode, next);
+                }
+
+                // narrow the text to fit maxWidth.
+                float width = pen * scale;
+                float scaleX = scale;
+                if (maxWidth > 0.0f && width > maxWidth)
+                {
+                    scaleX *= maxWidth / width;
+                    width = maxWidth;
+                }
+
+                float x = 0.0f;
+                float y = 0.0f;
+                bool rtl = state.direction == Direction::rtl;
+                switch (state.textAlign)
+                {
+                    case TextAlign::left:
+                        break;
+                    case TextAlign::right:
+                        x -= width;
+                        break;
+                    case TextAlign::center:
+                        x -= width * 0.5f;
+                        break;
+                    case TextAlign::start:
+                        x -= rtl ? width : 0.0f;
+                        break;
+                    case TextAlign::end:
+                        x -= rtl ? 0.0f : width;
+                        break;
+                }
+
+                // packages without vertical metrics, guess them from the size.
+                float ascender = font->ascender() != 0.0f ? font->ascender() * scale : state.font.fontSize * 0.8f;
+                float descender = font->descender() != 0.0f ? font->descender() * scale : state.font.fontSize * -0.2f;
+                switch (state.textBaseline)
+                {
+                    case TextBaseline::top:
+                        y += ascender;
+                        break;
+                    case TextBaseline::hanging:
+                        y += ascender * 0.8f;
+                        break;
+                    case TextBaseline::middle:
+                        y += (ascender + descender) * 0.5f;
+                        break;
+                    case TextBaseline::alphabetic:
+                        break;
+                    case TextBaseline::ideographic:
+                    case TextBaseline::bottom:
+                        y += descender;
+                        break;
+                }
+
+                glm::vec2 origin(x, y);
+                glm::vec2 glyphScale(scaleX, scale);
+                float range = font->distanceRange() * glm::min(scaleX, scale);
+                for (size_t k = 0; k < quads.size(); ++k)
+                {
+                    quads.topLeft(k) = origin + quads.topLeft(k) * glyphScale;
+                    quads.bottomRight(k) = origin + quads.bottomRight(k) * glyphScale;
+                    quads.range(k) = range;
+                }
+
+                metrics.width = width;
+                if (inkTopLeft.x <= inkBottomRight.x)
+                {
+                    inkTopLeft = origin + inkTopLeft * glyphScale;
+                    inkBottomRight = origin + inkBottomRight * glyphScale;
+                    metrics.actualBoundingBoxLeft = -inkTopLeft.x;
+                    metrics.actualBoundingBoxRight = inkBottomRight.x;
+                    metrics.actualBoundingBoxAscent = -inkTopLeft.y;
+                    metrics.actualBoundingBoxDescent = inkBottomRight.y;
+                }
+                metrics.fontBoundingBoxAscent = ascender - y;
+                metrics.fontBoundingBoxDescent = y - descender;
+
+                return run;
+            }
+
+            /*!
+             * \brief drawText queues the glyphs of text, laid out at x, y, as
+             * a single text draw.
+             */
+            inline void drawText(const ContextState &state, DrawOp op, const char *text, float x, float y, float maxWidth)
+            {
+                const TextRun *run = layoutText(state, text, maxWidth);
+                if (!run)
+                {
+                    return;
+                }
+
+                const GlyphQuadArray &quads = run->quads;
+                glm::vec2 origin(x, y);
+                uint32_t first = static_cast<uint32_t>(glyphQuads.size());
+                for (size_t k = 0; k < quads.size(); ++k)
+                {
+                    glyphQuads.push(static_cast<const Glyph*>(quads.glyph(k)),
+                                    origin + quads.topLeft(k),
+                                    origin + quads.bottomRight(k),
+                                    static_cast<float>(quads.range(k)));
+                }
+
+                renderQueue.push(std::move(op),
+                                 Path2D(textPath),
+                                 internState(state),
+                                 nullptr,
+                                 FillRule::nonzero,
+                                 1.0f,
+                                 std::move(first),
+                                 static_cast<uint32_t>(quads.size()));
+            }
+
+            inline TextMetrics measureText(const ContextState &state, const char *text)
+            {
+                const TextRun *run = layoutText(state, text, FLT_MAX);
+                return run ? run->metrics : TextMetrics();
+            }
+        };
+
+
+    }
+
+    Context::Context() :
+        ctx(new detail::ContextPriv())
+    {
+    }
+
+    Context::~Context()
+    {
+    }
+
+    const char * Context::backendName() const
+    {
+        return "GL";
+    }
+
+    void Context::clearFrame(int32_t fbLeft, int32_t fbTop, int32_t fbWidth, int32_t fbHeight, Color backgroundColor)
+    {
+        ctx->clearFrame(std::move(fbLeft), std::move(fbTop),
+                        std::move(fbWidth), std::move(fbHeight),
+                        std::move(backgroundColor));
+    }
+
+    void Context::beginFrame(int32_t winWidth, int32_t winHeight, float devicePixelRatio)
+    {
+        ctx->beginFrame(std::move(winWidth), std::move(winHeight), std::move(devicePixelRatio));
+    }
+
+    void Context::endFrame()
+    {
+        ctx->endFrame();
+    }
+
+    bool Context::loadFonts(const std::string &path)
+    {
+        return ctx->loadFonts(path);
+    }
+
+    void Context::setExecutor(Executor *executor)
+    {
+        ctx->executor = executor ? executor : &detail::defaultJobSystem();
+    }
+
+    void Context::setTessellationCacheBudget(size_t bytes)
+    {
+        ctx->tessellationCache.budget = bytes;
+    }
+
+    void Context::setTessellationObserver(std::function<void(bool)> observer)
+    {
+        ctx->tessellationObserver = std::move(observer);
+    }
+
+    void Context::setFillMode(FillMode mode)
+    {
+        ctx->fillMode = mode;
+    }
+
+    FillMode Context::fillMode() const
+    {
+        return ctx->fillMode;
+    }
+
+    const FrameStats &Context::frameStats() const
+    {
+        return ctx->stats;
+    }
+
+    void Context::save()
+    {
+        ctx->states.push_back(*this);
+    }
+
+    void Context::restore()
+    {
+        if (ctx->states.size() > 0)
+        {
+            *static_cast<ContextState*>(this) = ctx->states.back();
+            ctx->states.pop_back();
+        }
+    }
+
+    void Context::clearRect(float x, float y, float width, float height)
+    {
+        Paint origFillStyle = fillStyle;
+        fillStyle = detail::gfxStates.backgroundColor;
+        rect(x, y, width, height);
+        fill();
+        fillStyle = origFillStyle;
+    }
+
+    void Context::fillText(const char *text, float x, float y, float maxWidth)
+    {
+        ctx->drawText(*this, detail::DRAW_TEXT_FILL, text, x, y, maxWidth);
+    }
+
+    void Context::strokeText(const char *text, float x, float y, float maxWidth)
+    {
+        ctx->drawText(*this, detail::DRAW_TEXT_STROKE, text, x, y, maxWidth);
+    }
+
+    TextMetrics Context::measureText(const char *text)
+    {
+        return ctx->measureText(*this, text);
+    }
+
+    void Context::fill(Path2D &path, FillRule fillRule)
+    {
+        ctx->renderQueue.push(ctx->fillMode == FillMode::stencilThenCover ? detail::DRAW_FILL_STENCIL : detail::DRAW_FILL,
+                              path.clone<Path2D>(),
+                              ctx->internState(*this),
+                              nullptr,
+                              std::move(fillRule),
+                              ctx->tessellationScale(currentTransform),
+                              0, 0);
+        path.reset();
+    }
+
+    void Context::fillInstances(Path2D &path, const SVGMatrix *transforms, const Color *colors, size_t count)
+    {
+        if (count == 0)
+        {
+            path.reset();
+            return;
+        }
+
+        Color fillColor = fillStyle.colorStops().color(0);
+        uint32_t first = static_cast<uint32_t>(ctx->instances.size());
+        float scale = 0.0f;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            SVGMatrix transform = ctx->multiply(currentTransform, transforms[i]);
+            scale = glm::max(scale, ctx->tessellationScale(transform));
+            ctx->instances.push(std::move(transform), colors ? Color(colors[i]) : Color(fillColor));
+        }
+
+        ctx->renderQueue.push(detail::DRAW_FILL_INSTANCED,
+                              path.clone<Path2D>(),
+                              ctx->internState(*this),
+                              nullptr,
+                              FillRule::nonzero,
+                              std::move(scale),
+                              std::move(first),
+                              static_cast<uint32_t>(count));
+        path.reset();
+    }
+
+    void Context::stroke(Path2D &path)
+    {
+        ctx->renderQueue.push(detail::DRAW_STROKE,
+                              path.clone<Path2D>(),
+                              ctx->internState(*this),
+                              nullptr,
+                              FillRule::nonzero,
+                              ctx->tessellationScale(currentTransform),
+                              0, 0);
+        path.reset();
+    }
+
+    void Image::sourceChanged(detail::ContextPriv *ctx)
+    {
+        // Decoded from a copy, created and destroyed on this thread, so the
+        // image may be dropped, or decoded again once evicted, meanwhile. The
+        // worker only fills its own buffer: the SoA storage of the images may
+        // be reallocated by this thread at any time, so the image itself is
+        // only written to back here, from the task queue.
+        auto decodeTask = +[](Image *self, std::string url)->void
+        {
+            #if defined(TUNIS_PROFILING)
+            EASY_THREAD_SCOPE(url);
+            EASY_FUNCTION();
+            #endif
+
+            int w, h, n;
+            uint8_t *raw = stbi_load(url.c_str(), &w, &h, &n, 4); // force RGBA
+
+            if (!raw)
+            {
+                fprintf(stderr, "Could not load %s : %s\n", url.c_str(), stbi_failure_reason());
+                detail::taskQueue.enqueue([self](detail::ContextPriv *) {
+                    // not decoded again until its source changes.
+                    self->loading() = false;
+                    self->failed() = true;
+                    delete self;
+                });
+                return;
+            }
+
+            // the image adopts the buffer of stb as is, and the padding is
+            // added by the uploader, straight into the staging buffer, see
+            // ImageUploader::pad(). Like self, raw is owned by the task.
+            detail::taskQueue.enqueue([self, raw, w, h](detail::ContextPriv *ctx) {
+                int pw = w + detail::gfxStates.texPadding + detail::gfxStates.texPadding;
+                int ph = h + detail::gfxStates.texPadding + detail::gfxStates.texPadding;
+
+                self->data() = detail::PixelBuffer(raw, static_cast<size_t>(w) * h * 4, &stbi_image_free);
+                self->bounds().setWidth(w);
+                self->bounds().setHeight(h);
+                self->paddedBounds().setWidth(pw);
+                self->paddedBounds().setHeight(ph);
+                self->dataChanged(ctx);
+                delete self;
+            });
+        };
+
+        loading() = true;
+        failed() = false;
+        ctx->executor->submit(std::bind(decodeTask, new Image(*this), source()));
+    }
+
+    void Image::dataChanged(detail::ContextPriv *ctx)
+    {
+        // the new data may not fit where the old one was.
+        if (parent())
+        {
+            parent()->removeImage(*this);
+        }
+
+        // retried when drawn if it does not fit.
+        loading() = ctx->addImage(*this);
     }
 
 }
@@ -0,0 +1,98 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISDATATEXTURE_H
+#define TUNISDATATEXTURE_H
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#include <TunisGL.h>
+
+#include <glm/common.hpp>
+#include <glm/vec4.hpp>
+
+namespace tunis
+{
+    namespace detail
+    {
+        /*!
+         * \brief DataTexture is a RGBA32F texture that the shaders read as an
+         * array of vec4, one per texel, row by row. It is sampled with nearest
+         * filtering, and grows its height to fit whatever is uploaded to it.
+         *
+         * Without float textures, it is packed instead: every vec4 takes four
+         * RGBA8 texels, each holding the bits of one of its floats, most
+         * significant byte first. Shaders compiled with
+         * TUNIS_PACKED_GRADIENTS unpack them.
+         */
+        class DataTexture
+        {
+        public:
+            DataTexture(int32_t width);
+            ~DataTexture();
+
+            DataTexture(const DataTexture &) = delete;
+            DataTexture &operator=(const DataTexture &) = delete;
+
+            /*!
+             * \brief isSupported returns whether the context can sample float
+             * textures.
+             */
+            static bool isSupported();
+
+            /*!
+             * \brief isPacked returns whether the vec4 are packed in RGBA8
+             * texels, because float textures are not supported.
+             */
+            bool isPacked() const;
+
+            /*!
+             * \brief upload replaces the first count texels of the texture.
+             */
+            void upload(const glm::vec4 *texels, size_t count);
+
+            void bind();
+
+            /*!
+             * \brief width returns the number of vec4 per row, four times
+             * fewer than the texels of a packed texture.
+             */
+            int32_t width() const;
+            int32_t height() const;
+
+        private:
+
+            GLuint handle;
+            GLint internalFormat;
+            GLenum type;
+            int32_t w, h;
+            std::vector<uint8_t> packed; // the texels to upload, when packed.
+        };
+    }
+}
+
+#include "TunisDataTexture.inl"
+
+#endif // TUNISDATATEXTURE_H
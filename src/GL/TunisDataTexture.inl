@@ -0,0 +1,180 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisDataTexture.h>
+#include <TunisGL.h>
+
+#include <TunisGraphicStates.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace tunis
+{
+    namespace detail
+    {
+        inline DataTexture::DataTexture(int32_t width) :
+            handle(0),
+            internalFormat(GL_RGBA32F),
+            type(GL_FLOAT),
+            w(width),
+            h(0)
+        {
+            if (!isSupported())
+            {
+                internalFormat = GL_RGBA;
+                type = GL_UNSIGNED_BYTE;
+            }
+            else if (tunisGLSupport(GL_ES_VERSION_2_0) && !tunisGLSupport(GL_ES_VERSION_3_0))
+            {
+                // OpenGL ES 2 only takes unsized internal formats, the type of
+                // the texels decides of their size.
+                internalFormat = GL_RGBA;
+            }
+
+            glGenTextures(1, &handle);
+            glBindTexture(GL_TEXTURE_2D, handle);
+            gfxStates.textureId = handle;
+
+            // the texels are data, never interpolate them.
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+
+        inline DataTexture::~DataTexture()
+        {
+            if (gfxStates.textureId == handle)
+            {
+                gfxStates.textureId = 0;
+                glBindTexture(GL_TEXTURE_2D, 0);
+            }
+
+            glDeleteTextures(1, &handle);
+            handle = 0;
+        }
+
+        inline bool DataTexture::isSupported()
+        {
+            return tunisGLSupport(GL_VERSION_3_0) ||
+                   tunisGLSupport(GL_ES_VERSION_3_0) ||
+                   tunisGLSupport(GL_ARB_texture_float) ||
+                   tunisGLSupport(GL_OES_texture_float);
+        }
+
+        inline bool DataTexture::isPacked() const
+        {
+            return type == GL_UNSIGNED_BYTE;
+        }
+
+        inline void DataTexture::upload(const glm::vec4 *texels, size_t count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            int32_t rows = static_cast<int32_t>((count + w - 1) / w);
+
+            if (rows > gfxStates.maxTexSize)
+            {
+                fprintf(stderr, "DataTexture %d cannot hold %zu texels, dropping the last ones.\n", handle, count);
+                rows = gfxStates.maxTexSize;
+                count = static_cast<size_t>(rows) * w;
+            }
+
+            const void *pixels = texels;
+            size_t texelSize = sizeof(glm::vec4);
+            int32_t texelsPerVec4 = 1;
+            if (isPacked())
+            {
+                packed.resize(count * 16);
+                uint8_t *dst = packed.data();
+                for (size_t i = 0; i < count; ++i)
+                {
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        uint32_t bits;
+                        memcpy(&bits, &texels[i][c], 4);
+                        *dst++ = static_cast<uint8_t>(bits >> 24);
+                        *dst++ = static_cast<uint8_t>(bits >> 16);
+                        *dst++ = static_cast<uint8_t>(bits >> 8);
+                        *dst++ = static_cast<uint8_t>(bits);
+                    }
+                }
+                pixels = packed.data();
+                texelSize = 16;
+                texelsPerVec4 = 4;
+            }
+
+            bind();
+
+            if (rows > h)
+            {
+                // grow by powers of two so it settles after a few frames.
+                int32_t height = glm::max(h, 1);
+                while (height < rows)
+                {
+                    height *= 2;
+                }
+                h = glm::min(height, gfxStates.maxTexSize);
+
+                glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, w * texelsPerVec4, h, 0, GL_RGBA, type, nullptr);
+            }
+
+            // the full rows first, then what is left of the last one.
+            int32_t fullRows = static_cast<int32_t>(count / w);
+            if (fullRows > 0)
+            {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w * texelsPerVec4, fullRows, GL_RGBA, type, pixels);
+            }
+
+            int32_t remainder = static_cast<int32_t>(count % w);
+            if (remainder > 0)
+            {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, fullRows, remainder * texelsPerVec4, 1, GL_RGBA, type,
+                                static_cast<const uint8_t*>(pixels) + static_cast<size_t>(fullRows) * w * texelSize);
+            }
+        }
+
+        inline void DataTexture::bind()
+        {
+            if (gfxStates.textureId != handle)
+            {
+                glBindTexture(GL_TEXTURE_2D, handle);
+                gfxStates.textureId = handle;
+            }
+        }
+
+        inline int32_t DataTexture::width() const
+        {
+            return w;
+        }
+
+        inline int32_t DataTexture::height() const
+        {
+            return h;
+        }
+    }
+}
@@ -0,0 +1,157 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISFONTCACHE_H
+#define TUNISFONTCACHE_H
+
+#include <TunisFontDef.h>
+#include <TunisFonts_generated.h>
+
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tunis
+{
+    namespace detail
+    {
+        // codepoints per glyph page, see GlyphPage in TunisFonts.fbs.
+        static const uint32_t GlyphPageSize = 256;
+
+        // decoded in place of the malformed UTF-8 sequences.
+        static const uint32_t ReplacementCharacter = 0xFFFD;
+
+        /*!
+         * \brief decodeUtf8 returns the codepoint of the UTF-8 sequence text
+         * points to, and moves text past it. Malformed sequences decode to
+         * ReplacementCharacter. text must not point to its terminator.
+         */
+        uint32_t decodeUtf8(const char *&text);
+
+        /*!
+         * \brief FontFace is a font of the repository prepared for the text
+         * layout: its glyphs are indexed by their codepoint, one page of
+         * GlyphPageSize codepoints at a time, and the kerning of its glyph
+         * pairs are hashed, so laying a string out never searches the package.
+         *
+         * A page is only read from the package, and verified, once one of its
+         * codepoints is looked up, so the pages of a mapped package that are
+         * never drawn are never loaded from disk.
+         */
+        class FontFace
+        {
+        public:
+
+            explicit FontFace(const Font *font);
+
+            FontFace(const FontFace &) = delete;
+            FontFace &operator=(const FontFace &) = delete;
+
+            const Font *font() const;
+
+            /*!
+             * \brief glyph returns the glyph of unicode, or nullptr if the font
+             * has none, loading its page the first time.
+             */
+            const Glyph *glyph(uint32_t unicode);
+
+            /*!
+             * \brief kerning returns the offset to add to the pen between the
+             * glyphs of left and right, at the size of the font. The glyph of
+             * left must have been looked up already.
+             */
+            float kerning(uint32_t left, uint32_t right) const;
+
+            /*!
+             * \brief pageCount returns the pages loaded so far.
+             */
+            size_t pageCount() const;
+
+        private:
+
+            struct GlyphTable
+            {
+                const Glyph *glyphs[GlyphPageSize]; // nullptr if missing.
+            };
+
+            void loadPage(uint32_t first, GlyphTable &table);
+            void addKernings(const Glyph *glyph);
+
+            const Font *f;
+            std::vector<std::unique_ptr<GlyphTable>> pages; // by first codepoint / GlyphPageSize, nullptr until looked up.
+            size_t loadedPages = 0;
+            std::unordered_map<uint64_t, float> kernings; // by left << 32 | right.
+        };
+
+        /*!
+         * \brief FontCache resolves the font definitions of the context state
+         * to the faces of a font repository. Each definition is matched
+         * against the fonts of the repository once, then found by a hash of
+         * its family, weight and style.
+         */
+        class FontCache
+        {
+        public:
+
+            FontCache() = default;
+
+            FontCache(const FontCache &) = delete;
+            FontCache &operator=(const FontCache &) = delete;
+
+            /*!
+             * \brief reset forgets every face, and resolves the next
+             * definitions against repository instead.
+             */
+            void reset(const FontRepository *repository);
+
+            /*!
+             * \brief find returns the face of the font best matching fontDef,
+             * or nullptr if the repository has no suitable candidate.
+             */
+            FontFace *find(const FontDef &fontDef);
+
+        private:
+
+            const Font *match(const FontDef &fontDef) const;
+
+            struct Resolved
+            {
+                std::string family;
+                uint8_t weight;
+                bool italic;
+                FontFace *face; // nullptr when unmatched.
+            };
+
+            const FontRepository *repository = nullptr;
+            std::unordered_map<uint64_t, Resolved> resolved; // by hash of the definition.
+            std::unordered_map<const Font*, std::unique_ptr<FontFace>> faces;
+        };
+    }
+}
+
+#include "TunisFontCache.inl"
+
+#endif // TUNISFONTCACHE_H
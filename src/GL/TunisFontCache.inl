@@ -0,0 +1,277 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisFontCache.h>
+
+#include <TunisHash.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace tunis
+{
+    namespace detail
+    {
+        inline uint32_t decodeUtf8(const char *&text)
+        {
+            const uint8_t *c = reinterpret_cast<const uint8_t*>(text);
+
+            uint32_t unicode;
+            size_t length;
+            uint32_t min; // smaller values are overlong encodings.
+            if (c[0] < 0x80)
+            {
+                ++text;
+                return c[0];
+            }
+            else if ((c[0] & 0xE0) == 0xC0)
+            {
+                unicode = c[0] & 0x1F;
+                length = 2;
+                min = 0x80;
+            }
+            else if ((c[0] & 0xF0) == 0xE0)
+            {
+                unicode = c[0] & 0x0F;
+                length = 3;
+                min = 0x800;
+            }
+            else if ((c[0] & 0xF8) == 0xF0)
+            {
+                unicode = c[0] & 0x07;
+                length = 4;
+                min = 0x10000;
+            }
+            else
+            {
+                ++text; // stray continuation byte, or invalid lead byte.
+                return ReplacementCharacter;
+            }
+
+            for (size_t i = 1; i < length; ++i)
+            {
+                // the terminator fails this test too, so it is never skipped.
+                if ((c[i] & 0xC0) != 0x80)
+                {
+                    text += i;
+                    return ReplacementCharacter;
+                }
+                unicode = unicode << 6 | (c[i] & 0x3F);
+            }
+
+            text += length;
+
+            if (unicode < min || unicode > 0x10FFFF || (unicode >= 0xD800 && unicode <= 0xDFFF))
+            {
+                return ReplacementCharacter;
+            }
+
+            return unicode;
+        }
+
+        inline FontFace::FontFace(const Font *font) :
+            f(font)
+        {
+        }
+
+        inline const Font *FontFace::font() const
+        {
+            return f;
+        }
+
+        inline const Glyph *FontFace::glyph(uint32_t unicode)
+        {
+            uint32_t index = unicode / GlyphPageSize;
+            if (index < pages.size() && pages[index])
+            {
+                return pages[index]->glyphs[unicode % GlyphPageSize];
+            }
+
+            if (unicode > 0x10FFFF)
+            {
+                return nullptr;
+            }
+
+            if (index >= pages.size())
+            {
+                pages.resize(index + 1);
+            }
+
+            pages[index] = std::unique_ptr<GlyphTable>(new GlyphTable());
+            loadPage(index * GlyphPageSize, *pages[index]);
+            ++loadedPages;
+
+            return pages[index]->glyphs[unicode % GlyphPageSize];
+        }
+
+        inline float FontFace::kerning(uint32_t left, uint32_t right) const
+        {
+            if (kernings.empty())
+            {
+                return 0.0f;
+            }
+
+            auto it = kernings.find(static_cast<uint64_t>(left) << 32 | right);
+            return it != kernings.end() ? it->second : 0.0f;
+        }
+
+        inline size_t FontFace::pageCount() const
+        {
+            return loadedPages;
+        }
+
+        inline void FontFace::loadPage(uint32_t first, GlyphTable &table)
+        {
+            std::fill(table.glyphs, table.glyphs + GlyphPageSize, nullptr);
+
+            if (!f->pages())
+            {
+                // unpaged packages, from older packagers.
+                if (f->glyphs())
+                {
+                    for (uint32_t i = 0; i < GlyphPageSize; ++i)
+                    {
+                        table.glyphs[i] = f->glyphs()->LookupByKey(first + i);
+                        addKernings(table.glyphs[i]);
+                    }
+                }
+                return;
+            }
+
+            const GlyphPage *page = f->pages()->LookupByKey(first);
+            if (!page || !page->data())
+            {
+                return; // no glyph in this page.
+            }
+
+            flatbuffers::Verifier verifier(page->data()->data(), page->data()->size());
+            if (!verifier.VerifyBuffer<GlyphPageData>(nullptr))
+            {
+                fprintf(stderr, "Glyph page %u of %s is corrupted.\n", first, f->family()->c_str());
+                return;
+            }
+
+            const GlyphPageData *data = flatbuffers::GetRoot<GlyphPageData>(page->data()->data());
+            if (!data->glyphs())
+            {
+                return;
+            }
+
+            for (flatbuffers::uoffset_t i = 0; i < data->glyphs()->size(); ++i)
+            {
+                const Glyph *glyph = data->glyphs()->Get(i);
+                if (glyph->unicode() - first < GlyphPageSize)
+                {
+                    table.glyphs[glyph->unicode() - first] = glyph;
+                    addKernings(glyph);
+                }
+            }
+        }
+
+        inline void FontFace::addKernings(const Glyph *glyph)
+        {
+            if (!glyph || !glyph->kernings())
+            {
+                return;
+            }
+
+            for (flatbuffers::uoffset_t k = 0; k < glyph->kernings()->size(); ++k)
+            {
+                const Kerning *kerning = glyph->kernings()->Get(k);
+                uint64_t pair = static_cast<uint64_t>(glyph->unicode()) << 32 | kerning->unicode();
+                kernings[pair] = kerning->offset();
+            }
+        }
+
+        inline void FontCache::reset(const FontRepository *repository)
+        {
+            this->repository = repository;
+            resolved.clear();
+            faces.clear();
+        }
+
+        inline FontFace *FontCache::find(const FontDef &fontDef)
+        {
+            Hash hash;
+            hash.add(fontDef.family.data(), fontDef.family.size());
+            hash.add(fontDef.weight);
+            hash.add(fontDef.italic);
+
+            // compare the definition too, a collision must not pick the face
+            // of another family.
+            auto it = resolved.find(hash.value);
+            if (it != resolved.end() &&
+                it->second.weight == fontDef.weight &&
+                it->second.italic == fontDef.italic &&
+                it->second.family == fontDef.family)
+            {
+                return it->second.face;
+            }
+
+            FontFace *face = nullptr;
+            const Font *font = match(fontDef);
+            if (font)
+            {
+                std::unique_ptr<FontFace> &slot = faces[font];
+                if (!slot)
+                {
+                    slot = std::unique_ptr<FontFace>(new FontFace(font));
+                }
+                face = slot.get();
+            }
+
+            resolved[hash.value] = Resolved{fontDef.family, fontDef.weight, fontDef.italic, face};
+            return face;
+        }
+
+        inline const Font *FontCache::match(const FontDef &fontDef) const
+        {
+            if (!repository || !repository->fonts())
+            {
+                return nullptr;
+            }
+
+            const Font *font = nullptr;
+            for (flatbuffers::uoffset_t i = 0; i < repository->fonts()->size(); ++i)
+            {
+                const Font *candidate = repository->fonts()->Get(i);
+
+                if (fontDef.family == candidate->family()->c_str())
+                {
+                    font = candidate;
+
+                    if (candidate->weight() == fontDef.weight && candidate->italic() == fontDef.italic)
+                    {
+                        break; // perfect candidate!
+                    }
+                }
+                else if (!font && candidate->weight() <= fontDef.weight && candidate->italic() == fontDef.italic)
+                {
+                    font = candidate;
+                }
+            }
+
+            return font;
+        }
+    }
+}
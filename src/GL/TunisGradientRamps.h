@@ -0,0 +1,106 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISGRADIENTRAMPS_H
+#define TUNISGRADIENTRAMPS_H
+
+#include <TunisGL.h>
+#include <TunisGradient.h>
+
+#include <cinttypes>
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace tunis
+{
+    namespace detail
+    {
+        /*!
+         * \brief GradientRamps bakes the color stops of the gradients into
+         * the rows of a RGBA texture, one ramp per row, so the gradient
+         * shaders only need a single bilinear fetch per fragment whatever the
+         * number of stops.
+         *
+         * The ramps are cached by a hash of their color stops. When every row
+         * is taken, the least recently used ramp is replaced, unless it is
+         * drawn in the current frame, in which case the texture doubles its
+         * height instead.
+         *
+         * The texture stays bound to the second texture unit, GL_TEXTURE1.
+         */
+        class GradientRamps
+        {
+        public:
+
+            GradientRamps(int32_t width, int32_t height);
+            ~GradientRamps();
+
+            GradientRamps(const GradientRamps &) = delete;
+            GradientRamps &operator=(const GradientRamps &) = delete;
+
+            /*!
+             * \brief ramp returns the row of the ramp of colorStops, baking it
+             * if it is not cached already, and retains it until the end of the
+             * frame.
+             */
+            int32_t ramp(const ColorStopArray &colorStops);
+
+            /*!
+             * \brief endFrame releases the ramps retained in the current
+             * frame, so they can be replaced in the next ones.
+             */
+            void endFrame();
+
+            int32_t width() const;
+            int32_t height() const;
+
+            size_t rampCount() const;
+
+        private:
+
+            void bake(const ColorStopArray &colorStops, int32_t row);
+            void grow();
+
+            struct Entry
+            {
+                int32_t row;
+                uint64_t check; // the second hash of its color stops.
+                uint64_t frame; // last frame the ramp was drawn in.
+                std::list<uint64_t>::iterator lru;
+            };
+
+            GLuint handle = 0;
+            int32_t w, h;
+            uint64_t frame = 0;
+            std::unordered_map<uint64_t, Entry> entries;
+            std::list<uint64_t> lru; // most recently used first.
+            std::vector<uint8_t> pixels; // copy of the texture, to re-upload it when it grows.
+        };
+    }
+}
+
+#include "TunisGradientRamps.inl"
+
+#endif // TUNISGRADIENTRAMPS_H
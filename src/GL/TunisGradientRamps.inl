@@ -0,0 +1,192 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisGradientRamps.h>
+#include <TunisGL.h>
+
+#include <TunisGraphicStates.h>
+#include <TunisHash.h>
+
+#include <glm/common.hpp>
+#include <glm/vec4.hpp>
+
+namespace tunis
+{
+    namespace detail
+    {
+        inline GradientRamps::GradientRamps(int32_t width, int32_t height) :
+            w(width),
+            h(height),
+            pixels(static_cast<size_t>(width) * height * 4, 0)
+        {
+            glActiveTexture(GL_TEXTURE1);
+            glGenTextures(1, &handle);
+            glBindTexture(GL_TEXTURE_2D, handle);
+
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+            // interpolate along the ramps, but never between two of them.
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+            glActiveTexture(GL_TEXTURE0);
+        }
+
+        inline GradientRamps::~GradientRamps()
+        {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glActiveTexture(GL_TEXTURE0);
+
+            glDeleteTextures(1, &handle);
+            handle = 0;
+        }
+
+        inline int32_t GradientRamps::ramp(const ColorStopArray &colorStops)
+        {
+            Hash hash;
+            for (size_t i = 0; i < colorStops.size(); ++i)
+            {
+                hash.add(colorStops.offset(i));
+                hash.add(colorStops.color(i));
+            }
+
+            auto it = entries.find(hash.value);
+            if (it != entries.end())
+            {
+                Entry &entry = it->second;
+                entry.frame = frame;
+                lru.splice(lru.begin(), lru, entry.lru);
+
+                // a collision: bake over it, like past the maximum size.
+                if (entry.check != hash.check)
+                {
+                    entry.check = hash.check;
+                    bake(colorStops, entry.row);
+                }
+
+                return entry.row;
+            }
+
+            int32_t row;
+            if (entries.size() < static_cast<size_t>(h))
+            {
+                row = static_cast<int32_t>(entries.size());
+            }
+            else if (entries[lru.back()].frame != frame || h >= gfxStates.maxTexSize)
+            {
+                // replace the least recently used ramp. If it is drawn in
+                // this frame too, the texture is as big as it gets and that
+                // draw will pick up the wrong colors.
+                auto last = entries.find(lru.back());
+                row = last->second.row;
+                entries.erase(last);
+                lru.pop_back();
+            }
+            else
+            {
+                row = h;
+                grow();
+            }
+
+            lru.push_front(hash.value);
+            entries[hash.value] = Entry{row, hash.check, frame, lru.begin()};
+
+            bake(colorStops, row);
+
+            return row;
+        }
+
+        inline void GradientRamps::endFrame()
+        {
+            ++frame;
+        }
+
+        inline void GradientRamps::bake(const ColorStopArray &colorStops, int32_t row)
+        {
+            uint8_t *texels = &pixels[static_cast<size_t>(row) * w * 4];
+
+            // the same interpolation the gradient shaders used to do per
+            // fragment, once per texel. The first and last texels sit on the
+            // offsets 0 and 1.
+            for (int32_t x = 0; x < w; ++x)
+            {
+                float t = static_cast<float>(x) / static_cast<float>(w - 1);
+
+                glm::vec4 color(0.0f);
+                if (colorStops.size() > 0)
+                {
+                    const Color &first = colorStops.color(0);
+                    color = glm::vec4(first.r, first.g, first.b, first.a);
+                }
+
+                for (size_t i = 1; i < colorStops.size(); ++i)
+                {
+                    float offset = colorStops.offset(i-1);
+                    float nextOffset = colorStops.offset(i);
+                    const Color &next = colorStops.color(i);
+
+                    float a = nextOffset > offset ? glm::clamp((t - offset) / (nextOffset - offset), 0.0f, 1.0f) :
+                                                    (t < offset ? 0.0f : 1.0f);
+                    color = glm::mix(color, glm::vec4(next.r, next.g, next.b, next.a), a);
+                }
+
+                texels[x*4+0] = static_cast<uint8_t>(color.r + 0.5f);
+                texels[x*4+1] = static_cast<uint8_t>(color.g + 0.5f);
+                texels[x*4+2] = static_cast<uint8_t>(color.b + 0.5f);
+                texels[x*4+3] = static_cast<uint8_t>(color.a + 0.5f);
+            }
+
+            glActiveTexture(GL_TEXTURE1);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row, w, 1, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+            glActiveTexture(GL_TEXTURE0);
+        }
+
+        inline void GradientRamps::grow()
+        {
+            h = glm::min(h * 2, gfxStates.maxTexSize);
+            pixels.resize(static_cast<size_t>(w) * h * 4, 0);
+
+            glActiveTexture(GL_TEXTURE1);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            glActiveTexture(GL_TEXTURE0);
+        }
+
+        inline int32_t GradientRamps::width() const
+        {
+            return w;
+        }
+
+        inline int32_t GradientRamps::height() const
+        {
+            return h;
+        }
+
+        inline size_t GradientRamps::rampCount() const
+        {
+            return entries.size();
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISHASH_H
+#define TUNISHASH_H
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace tunis
+{
+    namespace detail
+    {
+        /*!
+         * \brief Hash accumulates a 64-bit FNV-1a hash in value and, in check,
+         * a second independent hash of the same bytes. Caches key their
+         * entries by value and compare check on a hit, so two different
+         * inputs are only mistaken for one another if both hashes collide.
+         */
+        struct Hash
+        {
+            uint64_t value = 14695981039346656037ULL;
+            uint64_t check = 0;
+
+            void add(const void *data, size_t size);
+
+            template <typename T>
+            inline void add(const T &v)
+            {
+                add(&v, sizeof(T));
+            }
+        };
+    }
+}
+
+#include "TunisHash.inl"
+
+#endif // TUNISHASH_H
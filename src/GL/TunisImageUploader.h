@@ -0,0 +1,132 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISIMAGEUPLOADER_H
+#define TUNISIMAGEUPLOADER_H
+
+#include <TunisGL.h>
+#include <TunisImage.h>
+#include <TunisStreamBuffer.h>
+
+#include <cinttypes>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace tunis
+{
+    namespace detail
+    {
+        class Texture;
+
+        /*!
+         * \brief ImageUploader hands the pixels of the images added to the
+         * atlas over to GL, a few at a time, so a burst of image loads is
+         * spread over several frames instead of stalling one.
+         *
+         * When pixel buffer objects can be mapped, the pixels are staged in a
+         * StreamBuffer bound to GL_PIXEL_UNPACK_BUFFER and copied to their
+         * texture by the GPU, asynchronously. The images stay loading()
+         * until the fence following their copy signals, and are not drawn
+         * before that. Otherwise, they are uploaded from system memory.
+         *
+         * Images are decoded without their padding, which is added while
+         * their pixels are written to the staging buffer. Their pixels are
+         * then released, the atlas holds the only copy.
+         */
+        class ImageUploader
+        {
+        public:
+
+            /*!
+             * \param budget bytes to upload per frame. Every frame uploads at
+             * least one image, however big. 0 uploads everything right away.
+             */
+            explicit ImageUploader(size_t budget);
+            ~ImageUploader();
+
+            ImageUploader(const ImageUploader &) = delete;
+            ImageUploader &operator=(const ImageUploader &) = delete;
+
+            /*!
+             * \brief enqueue queues the pixels of image, already given room in
+             * its parent texture, for upload.
+             */
+            void enqueue(Image &image);
+
+            /*!
+             * \brief update lets the images whose copy is done be drawn, then
+             * uploads the next ones within the budget.
+             *
+             * \return the number of bytes uploaded.
+             */
+            size_t update();
+
+            size_t pendingCount() const;
+
+            /*!
+             * \brief pad writes the pixels of image to dst, surrounded by
+             * gfxStates.texPadding copies of its edge pixels so bilinear
+             * filtering never bleeds in the neighbouring images of the atlas.
+             *
+             * \param dst paddedBounds().width() * paddedBounds().height() * 4
+             * bytes, 4-byte aligned.
+             */
+            static void pad(const Image &image, uint8_t *dst);
+
+        private:
+
+            struct Pending
+            {
+                Image image;
+                Texture *texture; // its parent when it was queued.
+                Point<int32_t> position; // its padded top left when it was queued.
+
+                /*!
+                 * \brief placed tells if image is still where it was queued,
+                 * i.e. neither evicted nor evicted and added back elsewhere.
+                 */
+                bool placed() const;
+            };
+
+            struct InFlight
+            {
+                GLsync fence;
+                std::vector<Pending> images;
+            };
+
+            size_t budget;
+            std::unique_ptr<StreamBuffer> staging; // nullptr without pixel buffer objects.
+            std::deque<Pending> pending;
+            std::deque<InFlight> inFlight;
+            std::vector<Pending> stagedImages;
+            std::vector<size_t> stagedOffsets;
+            std::vector<uint8_t> padded; // without pixel buffer objects.
+        };
+    }
+}
+
+#include "TunisImageUploader.inl"
+
+#endif // TUNISIMAGEUPLOADER_H
@@ -0,0 +1,221 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisImageUploader.h>
+#include <TunisGL.h>
+
+#include <TunisGraphicStates.h>
+#include <TunisTexture.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace tunis
+{
+    namespace detail
+    {
+        inline ImageUploader::ImageUploader(size_t budget) :
+            budget(budget)
+        {
+            bool pixelBufferObject = tunisGLSupport(GL_VERSION_2_1) ||
+                                     tunisGLSupport(GL_ES_VERSION_3_0) ||
+                                     tunisGLSupport(GL_ARB_pixel_buffer_object);
+
+            if (budget > 0 && pixelBufferObject && StreamBuffer::bestMode() == StreamBuffer::Mode::map)
+            {
+                staging = std::unique_ptr<StreamBuffer>(new StreamBuffer(GL_PIXEL_UNPACK_BUFFER, budget));
+
+                // the unpack buffer must only be bound while we source from it,
+                // or every other glTexSubImage2D would read from it too.
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            }
+        }
+
+        inline ImageUploader::~ImageUploader()
+        {
+            for (InFlight &batch : inFlight)
+            {
+                glDeleteSync(batch.fence);
+            }
+
+            staging.reset();
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+
+        inline void ImageUploader::enqueue(Image &image)
+        {
+            image.loading() = true;
+            pending.push_back(Pending{image, image.parent(), image.paddedBounds().topLeft()});
+        }
+
+        inline bool ImageUploader::Pending::placed() const
+        {
+            return image.parent() == texture && image.paddedBounds().topLeft() == position;
+        }
+
+        inline size_t ImageUploader::update()
+        {
+            // the images of the copies the GPU is done with can be drawn.
+            while (inFlight.size() > 0)
+            {
+                InFlight &batch = inFlight.front();
+                GLenum status = glClientWaitSync(batch.fence, 0, 0);
+                if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                {
+                    break;
+                }
+
+                glDeleteSync(batch.fence);
+                for (Pending &staged : batch.images)
+                {
+                    // unless it was evicted, and maybe is loading again.
+                    if (staged.placed())
+                    {
+                        staged.image.loading() = false;
+                    }
+                }
+                inFlight.pop_front();
+            }
+
+            size_t uploaded = 0;
+            while (pending.size() > 0)
+            {
+                Image image = pending.front().image;
+
+                // evicted, or dropped by the user, since it was queued.
+                if (!pending.front().placed())
+                {
+                    pending.pop_front();
+                    continue;
+                }
+
+                const auto &paddedBounds = image.paddedBounds();
+                size_t bytes = static_cast<size_t>(paddedBounds.width()) * paddedBounds.height() * 4;
+                if (budget > 0 && uploaded > 0 && uploaded + bytes > budget)
+                {
+                    break;
+                }
+
+                if (staging)
+                {
+                    size_t offset;
+                    uint8_t *dst = staging->allocate(bytes, 4, offset);
+                    if (!dst)
+                    {
+                        if (uploaded > 0)
+                        {
+                            break; // the segment is full, wait for the next one.
+                        }
+
+                        // bigger than a whole segment.
+                        staging->advance(bytes);
+                        dst = staging->allocate(bytes, 4, offset);
+                    }
+
+                    pad(image, dst);
+                    stagedImages.push_back(pending.front());
+                    stagedOffsets.push_back(offset);
+                }
+                else
+                {
+                    padded.resize(bytes);
+                    pad(image, padded.data());
+                    image.parent()->upload(image, padded.data());
+                    image.loading() = false;
+                }
+
+                // the atlas has the only copy from now on.
+                image.data().reset();
+
+                uploaded += bytes;
+                pending.pop_front();
+            }
+
+            if (stagedImages.size() > 0)
+            {
+                // unmaps the staged pixels, and leaves the buffer bound.
+                staging->flush();
+
+                for (size_t i = 0; i < stagedImages.size(); ++i)
+                {
+                    stagedImages[i].image.parent()->upload(stagedImages[i].image, reinterpret_cast<const void*>(stagedOffsets[i]));
+                }
+
+                InFlight batch;
+                batch.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                batch.images.swap(stagedImages);
+                inFlight.push_back(std::move(batch));
+
+                staging->advance();
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+                stagedImages.resize(0);
+                stagedOffsets.resize(0);
+            }
+
+            return uploaded;
+        }
+
+        inline void ImageUploader::pad(const Image &image, uint8_t *dst)
+        {
+            const uint8_t *src = image.data().data();
+            int32_t width = image.bounds().width();
+            int32_t height = image.bounds().height();
+            int32_t padding = gfxStates.texPadding;
+            size_t rowSize = static_cast<size_t>(width) * 4;
+            size_t paddedRowSize = rowSize + static_cast<size_t>(padding) * 8;
+
+            uint8_t *row = dst + paddedRowSize * static_cast<size_t>(padding);
+            for (int32_t y = 0; y < height; ++y)
+            {
+                uint32_t left, right;
+                memcpy(&left, src, 4);
+                memcpy(&right, src + rowSize - 4, 4);
+
+                // whole pixels at once, the compiler vectorizes the fills.
+                uint32_t *pixels = reinterpret_cast<uint32_t*>(row);
+                std::fill(pixels, pixels + padding, left);
+                memcpy(row + padding * 4, src, rowSize);
+                std::fill(pixels + padding + width, pixels + padding + width + padding, right);
+
+                src += rowSize;
+                row += paddedRowSize;
+            }
+
+            // the padded first and last rows, corners included, extend above
+            // and below.
+            const uint8_t *first = dst + paddedRowSize * static_cast<size_t>(padding);
+            const uint8_t *last = row - paddedRowSize;
+            for (int32_t y = 0; y < padding; ++y)
+            {
+                memcpy(dst + paddedRowSize * static_cast<size_t>(y), first, paddedRowSize);
+                memcpy(row + paddedRowSize * static_cast<size_t>(y), last, paddedRowSize);
+            }
+        }
+
+        inline size_t ImageUploader::pendingCount() const
+        {
+            return pending.size();
+        }
+    }
+}
@@ -48,7 +48,11 @@ namespace tunis
 
         protected:
 
-            void compile(GLenum type, const char *source, int len);
+            /*!
+             * \brief compile compiles source, of len characters, preceded by
+             * defines, e.g. "#define TUNIS_PACKED_GRADIENTS\n".
+             */
+            void compile(GLenum type, const char *source, int len, const char *defines = "");
 
             const char *shaderName;
             GLuint shaderId = 0;
@@ -73,7 +77,7 @@ namespace tunis
 
         class ShaderFragGradientLinear : public Shader
         {
-        public: ShaderFragGradientLinear();
+        public: explicit ShaderFragGradientLinear(bool packedGradients);
         };
 
         class ShaderVertGradientRadial : public Shader
@@ -83,7 +87,27 @@ namespace tunis
 
         class ShaderFragGradientRadial : public Shader
         {
-        public: ShaderFragGradientRadial();
+        public: explicit ShaderFragGradientRadial(bool packedGradients);
+        };
+
+        class ShaderVertInstance : public Shader
+        {
+        public: ShaderVertInstance();
+        };
+
+        class ShaderFragInstance : public Shader
+        {
+        public: ShaderFragInstance();
+        };
+
+        class ShaderVertMsdf : public Shader
+        {
+        public: ShaderVertMsdf();
+        };
+
+        class ShaderFragMsdf : public Shader
+        {
+        public: ShaderFragMsdf();
         };
 
         class ShaderProgram
@@ -99,6 +123,13 @@ namespace tunis
 
             void setViewSizeUniform(int32_t width, int32_t height);
 
+            /*!
+             * \brief setVertexOffset sets the byte offset of the first vertex
+             * within the vertex buffer object, re-specifying the attribute
+             * pointers if it changed.
+             */
+            void setVertexOffset(size_t offset);
+
             virtual void enableVertexAttribArray() = 0;
             virtual void disableVertexAttribArray() = 0;
 
@@ -108,6 +139,9 @@ namespace tunis
             GLuint programId = 0;
             GLint linkStatus = GL_FALSE;
 
+            // byte offset of the first vertex in the vertex buffer object.
+            size_t vertexOffset = 0;
+
         private:
 
             // uniform locations
@@ -138,33 +172,6 @@ namespace tunis
 
         };
 
-        union UniformBlock
-        {
-            struct RadialGradient
-            {
-                glm::vec2 u_dt;
-                glm::vec2 u_focal;
-                float u_r0;
-                float u_dr;
-                float u_a;
-                float u_colorStopCount;
-                glm::vec4 u_offset;
-                glm::vec4 u_color[4];
-            } radialGradient;
-
-            struct LinearGradient
-            {
-                glm::vec2 u_start;
-                glm::vec2 u_dt;
-                float u_lenSq;
-                float UNUSED1;
-                float UNUSED2;
-                float u_colorStopCount;
-                glm::vec4 u_offset;
-                glm::vec4 u_color[4];
-            } linearGradient;
-        };
-
         class ShaderProgramGradient : public ShaderProgram
         {
         protected:
@@ -176,27 +183,99 @@ namespace tunis
             virtual void enableVertexAttribArray() override;
             virtual void disableVertexAttribArray() override;
 
-            void setUniforms(const UniformBlock &uniforms);
+            /*!
+             * \brief setGradientsSizeUniform sets the size, in texels, of the
+             * gradient data texture bound to the first texture unit.
+             */
+            void setGradientsSizeUniform(int32_t width, int32_t height);
+
+            /*!
+             * \brief setRampsSizeUniform sets the size, in texels, of the
+             * gradient ramps texture bound to the second texture unit.
+             */
+            void setRampsSizeUniform(int32_t width, int32_t height);
 
         private:
 
             // attribute locations
             GLint a_position = 0;
+            GLint a_gradient = 0;
+            GLint a_paintPosition = 0;
 
             // uniform lacations
-            GLint u_uniforms = 0;
+            GLint u_gradientsSize = 0;
+            GLint u_ramps = 0;
+            GLint u_rampsSize = 0;
+
+            int32_t gradientsWidth = 0;
+            int32_t gradientsHeight = 0;
+            int32_t rampsWidth = 0;
+            int32_t rampsHeight = 0;
         };
 
         class ShaderProgramGradientLinear : public ShaderProgramGradient
         {
         public:
-            ShaderProgramGradientLinear();
+            explicit ShaderProgramGradientLinear(bool packedGradients);
         };
 
         class ShaderProgramGradientRadial : public ShaderProgramGradient
         {
         public:
-            ShaderProgramGradientRadial();
+            explicit ShaderProgramGradientRadial(bool packedGradients);
+        };
+
+        class ShaderProgramInstance : public ShaderProgram
+        {
+        public:
+            ShaderProgramInstance();
+
+            virtual void enableVertexAttribArray() override;
+            virtual void disableVertexAttribArray() override;
+
+            /*!
+             * \brief enableInstanceAttribArray points the per-instance
+             * attributes at the VertexInstance array starting at offset bytes
+             * in the vertex buffer object, advancing once per instance.
+             */
+            void enableInstanceAttribArray(size_t offset);
+
+            /*!
+             * \brief disableInstanceAttribArray disables the per-instance
+             * attributes and resets their divisors, since the divisors belong
+             * to the attribute locations that the other programs reuse.
+             */
+            void disableInstanceAttribArray();
+
+        private:
+
+            // attribute locations
+            GLint a_position = 0;
+            GLint a_transform0 = 0;
+            GLint a_transform1 = 0;
+            GLint a_color = 0;
+        };
+
+        /*!
+         * \brief ShaderProgramMsdf draws glyph quads sampling the
+         * multi-channel signed distance fields of the glyphs in the atlas.
+         */
+        class ShaderProgramMsdf : public ShaderProgram
+        {
+        public:
+            ShaderProgramMsdf();
+
+            virtual void enableVertexAttribArray() override;
+            virtual void disableVertexAttribArray() override;
+
+        private:
+
+            // attribute locations
+            GLint a_position = 0;
+            GLint a_texcoord = 0;
+            GLint a_color = 0;
+            GLint a_range = 0;
+            GLint a_stroke = 0;
         };
     }
 
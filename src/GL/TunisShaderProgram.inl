@@ -62,10 +62,13 @@ namespace tunis
             return shaderName;
         }
 
-        inline void Shader::compile(GLenum type, const char *source, int len)
+        inline void Shader::compile(GLenum type, const char *source, int len, const char *defines)
         {
+            const char *sources[2] = {defines, source};
+            GLint lengths[2] = {static_cast<GLint>(strlen(defines)), len};
+
             shaderId = glCreateShader(type);
-            glShaderSource(shaderId, 1, &source, &len);
+            glShaderSource(shaderId, 2, sources, lengths);
             glCompileShader(shaderId);
             glGetShaderiv(shaderId, GL_COMPILE_STATUS, &compileStatus);
 
@@ -113,13 +116,14 @@ namespace tunis
             compile(GL_VERTEX_SHADER, source, static_cast<int>(strlen(source)));
         }
 
-        inline ShaderFragGradientLinear::ShaderFragGradientLinear() : Shader("ShaderFragGradientLinear")
+        inline ShaderFragGradientLinear::ShaderFragGradientLinear(bool packedGradients) : Shader("ShaderFragGradientLinear")
         {
             const char * source =
                 #include "GL/gradientLinear.frag"
                     ;
 
-            compile(GL_FRAGMENT_SHADER, source, static_cast<int>(strlen(source)));
+            compile(GL_FRAGMENT_SHADER, source, static_cast<int>(strlen(source)),
+                    packedGradients ? "#define TUNIS_PACKED_GRADIENTS\n" : "");
         }
 
 
@@ -132,12 +136,49 @@ namespace tunis
             compile(GL_VERTEX_SHADER, source, static_cast<int>(strlen(source)));
         }
 
-        inline ShaderFragGradientRadial::ShaderFragGradientRadial() : Shader("ShaderFragGradientRadial")
+        inline ShaderFragGradientRadial::ShaderFragGradientRadial(bool packedGradients) : Shader("ShaderFragGradientRadial")
         {
             const char * source =
                 #include "GL/gradientRadial.frag"
                     ;
 
+            compile(GL_FRAGMENT_SHADER, source, static_cast<int>(strlen(source)),
+                    packedGradients ? "#define TUNIS_PACKED_GRADIENTS\n" : "");
+        }
+
+        inline ShaderVertInstance::ShaderVertInstance() : Shader("ShaderVertInstance")
+        {
+            const char * source =
+                #include "GL/instance.vert"
+                    ;
+
+            compile(GL_VERTEX_SHADER, source, static_cast<int>(strlen(source)));
+        }
+
+        inline ShaderFragInstance::ShaderFragInstance() : Shader("ShaderFragInstance")
+        {
+            const char * source =
+                #include "GL/instance.frag"
+                    ;
+
+            compile(GL_FRAGMENT_SHADER, source, static_cast<int>(strlen(source)));
+        }
+
+        inline ShaderVertMsdf::ShaderVertMsdf() : Shader("ShaderVertMsdf")
+        {
+            const char * source =
+                #include "GL/msdf.vert"
+                    ;
+
+            compile(GL_VERTEX_SHADER, source, static_cast<int>(strlen(source)));
+        }
+
+        inline ShaderFragMsdf::ShaderFragMsdf() : Shader("ShaderFragMsdf")
+        {
+            const char * source =
+                #include "GL/msdf.frag"
+                    ;
+
             compile(GL_FRAGMENT_SHADER, source, static_cast<int>(strlen(source)));
         }
 
@@ -242,6 +283,17 @@ namespace tunis
             }
         }
 
+        inline void ShaderProgram::setVertexOffset(size_t offset)
+        {
+            assert(gfxStates.programId == programId);
+
+            if (vertexOffset != offset)
+            {
+                vertexOffset = offset;
+                enableVertexAttribArray();
+            }
+        }
+
         /**
          * ShaderProgramTexture
          */
@@ -265,11 +317,11 @@ namespace tunis
 
         inline void ShaderProgramTexture::enableVertexAttribArray()
         {
-            glVertexAttribPointer(static_cast<GLuint>(a_position),  decltype(VertexTexture::a_position)::length(),  GL_FLOAT,          GL_FALSE, sizeof(VertexTexture), reinterpret_cast<const void *>(offsetof(VertexTexture, a_position)));
-            glVertexAttribPointer(static_cast<GLuint>(a_texcoord),  decltype(VertexTexture::a_texcoord)::length(),  GL_UNSIGNED_SHORT, GL_TRUE,  sizeof(VertexTexture), reinterpret_cast<const void *>(offsetof(VertexTexture, a_texcoord)));
-            glVertexAttribPointer(static_cast<GLuint>(a_texoffset), decltype(VertexTexture::a_texoffset)::length(), GL_UNSIGNED_SHORT, GL_TRUE,  sizeof(VertexTexture), reinterpret_cast<const void *>(offsetof(VertexTexture, a_texoffset)));
-            glVertexAttribPointer(static_cast<GLuint>(a_texsize),   decltype(VertexTexture::a_texsize)::length(),   GL_UNSIGNED_SHORT, GL_TRUE,  sizeof(VertexTexture), reinterpret_cast<const void *>(offsetof(VertexTexture, a_texsize)));
-            glVertexAttribPointer(static_cast<GLuint>(a_color),     decltype(VertexTexture::a_color)::length(),     GL_UNSIGNED_BYTE,  GL_TRUE,  sizeof(VertexTexture), reinterpret_cast<const void *>(offsetof(VertexTexture, a_color)));
+            glVertexAttribPointer(static_cast<GLuint>(a_position),  decltype(VertexTexture::a_position)::length(),  GL_FLOAT,          GL_FALSE, sizeof(VertexTexture), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexTexture, a_position)));
+            glVertexAttribPointer(static_cast<GLuint>(a_texcoord),  decltype(VertexTexture::a_texcoord)::length(),  GL_UNSIGNED_SHORT, GL_TRUE,  sizeof(VertexTexture), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexTexture, a_texcoord)));
+            glVertexAttribPointer(static_cast<GLuint>(a_texoffset), decltype(VertexTexture::a_texoffset)::length(), GL_UNSIGNED_SHORT, GL_TRUE,  sizeof(VertexTexture), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexTexture, a_texoffset)));
+            glVertexAttribPointer(static_cast<GLuint>(a_texsize),   decltype(VertexTexture::a_texsize)::length(),   GL_UNSIGNED_SHORT, GL_TRUE,  sizeof(VertexTexture), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexTexture, a_texsize)));
+            glVertexAttribPointer(static_cast<GLuint>(a_color),     decltype(VertexTexture::a_color)::length(),     GL_UNSIGNED_BYTE,  GL_TRUE,  sizeof(VertexTexture), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexTexture, a_color)));
             glEnableVertexAttribArray(static_cast<GLuint>(a_position));
             glEnableVertexAttribArray(static_cast<GLuint>(a_texcoord));
             glEnableVertexAttribArray(static_cast<GLuint>(a_texoffset));
@@ -298,45 +350,184 @@ namespace tunis
 
             // attribute locations
             a_position = glGetAttribLocation(programId, "a_position");
+            a_gradient = glGetAttribLocation(programId, "a_gradient");
+            a_paintPosition = glGetAttribLocation(programId, "a_paintPosition");
             assert(a_position != -1);
+            assert(a_gradient != -1);
+            assert(a_paintPosition != -1);
 
 
             // uniform locations
-            u_uniforms = glGetUniformLocation(programId, "u_uniforms");
-            assert(u_uniforms != -1);
+            u_gradientsSize = glGetUniformLocation(programId, "u_gradientsSize");
+            u_ramps = glGetUniformLocation(programId, "u_ramps");
+            u_rampsSize = glGetUniformLocation(programId, "u_rampsSize");
+            assert(u_gradientsSize != -1);
+            assert(u_ramps != -1);
+            assert(u_rampsSize != -1);
+
+            // the ramps stay bound to the second texture unit.
+            useProgram();
+            glUniform1i(u_ramps, 1);
         }
 
 
         inline void ShaderProgramGradient::enableVertexAttribArray()
         {
-            glVertexAttribPointer(static_cast<GLuint>(a_position), decltype(VertexGradient::a_position)::length(), GL_FLOAT, GL_FALSE, sizeof(VertexGradient), reinterpret_cast<const void *>(offsetof(VertexGradient, a_position)));
+            glVertexAttribPointer(static_cast<GLuint>(a_position), decltype(VertexGradient::a_position)::length(), GL_FLOAT, GL_FALSE, sizeof(VertexGradient), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexGradient, a_position)));
+            glVertexAttribPointer(static_cast<GLuint>(a_gradient), 1,                                               GL_FLOAT, GL_FALSE, sizeof(VertexGradient), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexGradient, a_gradient)));
+            glVertexAttribPointer(static_cast<GLuint>(a_paintPosition), decltype(VertexGradient::a_paintPosition)::length(), GL_FLOAT, GL_FALSE, sizeof(VertexGradient), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexGradient, a_paintPosition)));
             glEnableVertexAttribArray(static_cast<GLuint>(a_position));
+            glEnableVertexAttribArray(static_cast<GLuint>(a_gradient));
+            glEnableVertexAttribArray(static_cast<GLuint>(a_paintPosition));
         }
 
         inline void ShaderProgramGradient::disableVertexAttribArray()
         {
             glDisableVertexAttribArray(static_cast<GLuint>(a_position));
+            glDisableVertexAttribArray(static_cast<GLuint>(a_gradient));
+            glDisableVertexAttribArray(static_cast<GLuint>(a_paintPosition));
+        }
+
+        inline void ShaderProgramGradient::setGradientsSizeUniform(int32_t width, int32_t height)
+        {
+            assert(gfxStates.programId == programId);
+
+            if (gradientsWidth != width || gradientsHeight != height)
+            {
+                glUniform2f(u_gradientsSize,
+                            static_cast<GLfloat>(width),
+                            static_cast<GLfloat>(height));
+                gradientsWidth = width;
+                gradientsHeight = height;
+            }
         }
 
-        inline void ShaderProgramGradient::setUniforms(const UniformBlock &f)
+        inline void ShaderProgramGradient::setRampsSizeUniform(int32_t width, int32_t height)
         {
             assert(gfxStates.programId == programId);
-            glUniform4fv(u_uniforms, static_cast<GLsizei>(sizeof(UniformBlock)/sizeof(glm::vec4)), reinterpret_cast<const GLfloat*>(&f));
+
+            if (rampsWidth != width || rampsHeight != height)
+            {
+                glUniform2f(u_rampsSize,
+                            static_cast<GLfloat>(width),
+                            static_cast<GLfloat>(height));
+                rampsWidth = width;
+                rampsHeight = height;
+            }
         }
 
-        inline  ShaderProgramGradientLinear::ShaderProgramGradientLinear() :
+        inline  ShaderProgramGradientLinear::ShaderProgramGradientLinear(bool packedGradients) :
             ShaderProgramGradient(ShaderVertGradientLinear(),
-                                  ShaderFragGradientLinear(),
+                                  ShaderFragGradientLinear(packedGradients),
                                   "ShaderProgramGradientLinear")
         {
         }
 
-        inline  ShaderProgramGradientRadial::ShaderProgramGradientRadial() :
+        inline  ShaderProgramGradientRadial::ShaderProgramGradientRadial(bool packedGradients) :
             ShaderProgramGradient(ShaderVertGradientRadial(),
-                                  ShaderFragGradientRadial(),
+                                  ShaderFragGradientRadial(packedGradients),
                                   "ShaderProgramGradientRadial")
         {
         }
+
+        /**
+         * ShaderProgramInstance
+         */
+
+        inline ShaderProgramInstance::ShaderProgramInstance() :
+            ShaderProgram(ShaderVertInstance(), ShaderFragInstance(), "ShaderProgramInstance")
+        {
+            // attribute locations
+            a_position   = glGetAttribLocation(programId, "a_position");
+            a_transform0 = glGetAttribLocation(programId, "a_transform0");
+            a_transform1 = glGetAttribLocation(programId, "a_transform1");
+            a_color      = glGetAttribLocation(programId, "a_color");
+
+            assert(a_position != -1);
+            assert(a_transform0 != -1);
+            assert(a_transform1 != -1);
+            assert(a_color != -1);
+        }
+
+        inline void ShaderProgramInstance::enableVertexAttribArray()
+        {
+            glVertexAttribPointer(static_cast<GLuint>(a_position), decltype(VertexPosition::a_position)::length(), GL_FLOAT, GL_FALSE, sizeof(VertexPosition), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexPosition, a_position)));
+            glEnableVertexAttribArray(static_cast<GLuint>(a_position));
+        }
+
+        inline void ShaderProgramInstance::disableVertexAttribArray()
+        {
+            glDisableVertexAttribArray(static_cast<GLuint>(a_position));
+        }
+
+        inline void ShaderProgramInstance::enableInstanceAttribArray(size_t offset)
+        {
+            assert(gfxStates.programId == programId);
+
+            glVertexAttribPointer(static_cast<GLuint>(a_transform0), decltype(VertexInstance::a_transform0)::length(), GL_FLOAT,         GL_FALSE, sizeof(VertexInstance), reinterpret_cast<const void *>(offset + offsetof(VertexInstance, a_transform0)));
+            glVertexAttribPointer(static_cast<GLuint>(a_transform1), decltype(VertexInstance::a_transform1)::length(), GL_FLOAT,         GL_FALSE, sizeof(VertexInstance), reinterpret_cast<const void *>(offset + offsetof(VertexInstance, a_transform1)));
+            glVertexAttribPointer(static_cast<GLuint>(a_color),      decltype(VertexInstance::a_color)::length(),      GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(VertexInstance), reinterpret_cast<const void *>(offset + offsetof(VertexInstance, a_color)));
+            glVertexAttribDivisor(static_cast<GLuint>(a_transform0), 1);
+            glVertexAttribDivisor(static_cast<GLuint>(a_transform1), 1);
+            glVertexAttribDivisor(static_cast<GLuint>(a_color), 1);
+            glEnableVertexAttribArray(static_cast<GLuint>(a_transform0));
+            glEnableVertexAttribArray(static_cast<GLuint>(a_transform1));
+            glEnableVertexAttribArray(static_cast<GLuint>(a_color));
+        }
+
+        inline void ShaderProgramInstance::disableInstanceAttribArray()
+        {
+            glVertexAttribDivisor(static_cast<GLuint>(a_transform0), 0);
+            glVertexAttribDivisor(static_cast<GLuint>(a_transform1), 0);
+            glVertexAttribDivisor(static_cast<GLuint>(a_color), 0);
+            glDisableVertexAttribArray(static_cast<GLuint>(a_transform0));
+            glDisableVertexAttribArray(static_cast<GLuint>(a_transform1));
+            glDisableVertexAttribArray(static_cast<GLuint>(a_color));
+        }
+
+        /**
+         * ShaderProgramMsdf
+         */
+
+        inline ShaderProgramMsdf::ShaderProgramMsdf() :
+            ShaderProgram(ShaderVertMsdf(), ShaderFragMsdf(), "ShaderProgramMsdf")
+        {
+            // attribute locations
+            a_position = glGetAttribLocation(programId, "a_position");
+            a_texcoord = glGetAttribLocation(programId, "a_texcoord");
+            a_color    = glGetAttribLocation(programId, "a_color");
+            a_range    = glGetAttribLocation(programId, "a_range");
+            a_stroke   = glGetAttribLocation(programId, "a_stroke");
+
+            assert(a_position != -1);
+            assert(a_texcoord != -1);
+            assert(a_color != -1);
+            assert(a_range != -1);
+            assert(a_stroke != -1);
+        }
+
+        inline void ShaderProgramMsdf::enableVertexAttribArray()
+        {
+            glVertexAttribPointer(static_cast<GLuint>(a_position), decltype(VertexGlyph::a_position)::length(), GL_FLOAT,          GL_FALSE, sizeof(VertexGlyph), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexGlyph, a_position)));
+            glVertexAttribPointer(static_cast<GLuint>(a_texcoord), decltype(VertexGlyph::a_texcoord)::length(), GL_UNSIGNED_SHORT, GL_TRUE,  sizeof(VertexGlyph), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexGlyph, a_texcoord)));
+            glVertexAttribPointer(static_cast<GLuint>(a_color),    decltype(VertexGlyph::a_color)::length(),    GL_UNSIGNED_BYTE,  GL_TRUE,  sizeof(VertexGlyph), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexGlyph, a_color)));
+            glVertexAttribPointer(static_cast<GLuint>(a_range),    1,                                           GL_FLOAT,          GL_FALSE, sizeof(VertexGlyph), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexGlyph, a_range)));
+            glVertexAttribPointer(static_cast<GLuint>(a_stroke),   1,                                           GL_FLOAT,          GL_FALSE, sizeof(VertexGlyph), reinterpret_cast<const void *>(vertexOffset + offsetof(VertexGlyph, a_stroke)));
+            glEnableVertexAttribArray(static_cast<GLuint>(a_position));
+            glEnableVertexAttribArray(static_cast<GLuint>(a_texcoord));
+            glEnableVertexAttribArray(static_cast<GLuint>(a_color));
+            glEnableVertexAttribArray(static_cast<GLuint>(a_range));
+            glEnableVertexAttribArray(static_cast<GLuint>(a_stroke));
+        }
+
+        inline void ShaderProgramMsdf::disableVertexAttribArray()
+        {
+            glDisableVertexAttribArray(static_cast<GLuint>(a_position));
+            glDisableVertexAttribArray(static_cast<GLuint>(a_texcoord));
+            glDisableVertexAttribArray(static_cast<GLuint>(a_color));
+            glDisableVertexAttribArray(static_cast<GLuint>(a_range));
+            glDisableVertexAttribArray(static_cast<GLuint>(a_stroke));
+        }
     }
 
 }
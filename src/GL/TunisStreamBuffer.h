@@ -0,0 +1,121 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISSTREAMBUFFER_H
+#define TUNISSTREAMBUFFER_H
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#include <TunisGL.h>
+
+namespace tunis
+{
+    namespace detail
+    {
+        /*!
+         * \brief StreamBuffer is a buffer object split in a ring of segments.
+         * The CPU fills one segment while the GPU is still reading from the
+         * previous ones, and a segment is only waited on once the ring wraps
+         * around to it.
+         *
+         * When glMapBufferRange and sync objects are available, the data is
+         * written straight into unsynchronized mapped memory. Otherwise it is
+         * staged in system memory and uploaded with glBufferSubData.
+         */
+        class StreamBuffer
+        {
+        public:
+
+            enum class Mode
+            {
+                map,        //!< unsynchronized glMapBufferRange, fenced segments.
+                subData,    //!< system memory staging, glBufferSubData uploads.
+                bufferData  //!< system memory staging, glBufferData re-specifies the whole store.
+            };
+
+            StreamBuffer(GLenum target, size_t segmentSize, Mode mode = bestMode());
+            ~StreamBuffer();
+
+            StreamBuffer(const StreamBuffer &) = delete;
+            StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+            /*!
+             * \brief allocate reserves size bytes in the current segment.
+             *
+             * \param size number of bytes to reserve.
+             * \param alignment alignment of the returned offset, relative to
+             * the start of the buffer object.
+             * \param offset receives the offset of the reserved bytes within
+             * the buffer object.
+             * \return a write-only pointer to the reserved bytes, or nullptr
+             * if the current segment cannot fit them.
+             */
+            uint8_t *allocate(size_t size, size_t alignment, size_t &offset);
+
+            /*!
+             * \brief flush makes every byte allocated since the last flush
+             * visible to GL. It must be called before any draw sourcing them.
+             */
+            void flush();
+
+            /*!
+             * \brief advance flushes and fences the current segment, then moves
+             * to the next one, waiting for the GPU if it is still in use.
+             *
+             * \param minSegmentSize grows every segment to at least this size.
+             */
+            void advance(size_t minSegmentSize = 0);
+
+            size_t segmentSize() const;
+            Mode mode() const;
+            operator GLuint() const;
+
+            static Mode bestMode();
+
+        private:
+
+            void bind();
+            void map();
+            void wait(size_t id);
+
+            static const size_t SegmentCount = 3;
+
+            GLenum target;
+            Mode streamMode;
+            GLuint handle = 0;
+            size_t size;
+            size_t segment = 0;
+            size_t head = 0;    // next free byte, relative to the segment start.
+            size_t flushed = 0; // first byte not yet visible to GL, relative to the segment start.
+            uint8_t *mapped = nullptr; // mapped address of the 'flushed' byte.
+            GLsync fences[SegmentCount] = {};
+            std::vector<uint8_t> staging;
+        };
+    }
+}
+
+#include "TunisStreamBuffer.inl"
+
+#endif // TUNISSTREAMBUFFER_H
@@ -0,0 +1,274 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include "TunisStreamBuffer.h"
+
+#include <cassert>
+
+namespace tunis
+{
+    namespace detail
+    {
+        inline StreamBuffer::StreamBuffer(GLenum target, size_t segmentSize, Mode mode) :
+            target(target),
+            streamMode(mode),
+            size(segmentSize)
+        {
+            glGenBuffers(1, &handle);
+            bind();
+
+            if (streamMode == Mode::bufferData)
+            {
+                // the store is re-specified at every flush.
+                staging.resize(size);
+                return;
+            }
+
+            glBufferData(target, static_cast<GLsizeiptr>(size * SegmentCount), nullptr, GL_STREAM_DRAW);
+
+            if (streamMode == Mode::subData)
+            {
+                staging.resize(size);
+            }
+        }
+
+        inline StreamBuffer::~StreamBuffer()
+        {
+            if (mapped)
+            {
+                bind();
+                glUnmapBuffer(target);
+                mapped = nullptr;
+            }
+
+            for (size_t i = 0; i < SegmentCount; ++i)
+            {
+                if (fences[i])
+                {
+                    glDeleteSync(fences[i]);
+                    fences[i] = nullptr;
+                }
+            }
+
+            glDeleteBuffers(1, &handle);
+            handle = 0;
+        }
+
+        inline uint8_t *StreamBuffer::allocate(size_t bytes, size_t alignment, size_t &offset)
+        {
+            size_t base = (streamMode == Mode::bufferData) ? 0 : segment * size;
+
+            // align relative to the start of the buffer object so the offset
+            // can be turned into a base vertex.
+            size_t start = ((base + head + alignment - 1) / alignment) * alignment - base;
+
+            if (start + bytes > size)
+            {
+                return nullptr;
+            }
+
+            if (streamMode == Mode::map && !mapped)
+            {
+                map();
+            }
+
+            head = start + bytes;
+            offset = base + start;
+
+            if (streamMode == Mode::map)
+            {
+                return mapped + (start - flushed);
+            }
+
+            return staging.data() + start;
+        }
+
+        inline void StreamBuffer::flush()
+        {
+            if (head == flushed)
+            {
+                return;
+            }
+
+            bind();
+
+            switch(streamMode)
+            {
+                case Mode::map:
+                    glFlushMappedBufferRange(target, 0, static_cast<GLsizeiptr>(head - flushed));
+                    glUnmapBuffer(target);
+                    mapped = nullptr;
+                    flushed = head;
+                    break;
+                case Mode::subData:
+                    glBufferSubData(target,
+                                    static_cast<GLintptr>(segment * size + flushed),
+                                    static_cast<GLsizeiptr>(head - flushed),
+                                    staging.data() + flushed);
+                    flushed = head;
+                    break;
+                case Mode::bufferData:
+                    // orphan the previous store, the draws already issued keep
+                    // sourcing it.
+                    glBufferData(target,
+                                 static_cast<GLsizeiptr>(head),
+                                 staging.data(),
+                                 GL_STREAM_DRAW);
+                    head = 0;
+                    flushed = 0;
+                    break;
+            }
+        }
+
+        inline void StreamBuffer::advance(size_t minSegmentSize)
+        {
+            flush();
+
+            if (minSegmentSize > size)
+            {
+                // grow geometrically so a steadily growing scene does not
+                // re-allocate every frame.
+                while (size < minSegmentSize)
+                {
+                    size *= 2;
+                }
+
+                for (size_t i = 0; i < SegmentCount; ++i)
+                {
+                    if (fences[i])
+                    {
+                        glDeleteSync(fences[i]);
+                        fences[i] = nullptr;
+                    }
+                }
+
+                if (streamMode != Mode::bufferData)
+                {
+                    // orphan the old store, in-flight draws keep sourcing it.
+                    bind();
+                    glBufferData(target, static_cast<GLsizeiptr>(size * SegmentCount), nullptr, GL_STREAM_DRAW);
+                }
+
+                if (streamMode != Mode::map)
+                {
+                    staging.resize(size);
+                }
+
+                segment = 0;
+                head = 0;
+                flushed = 0;
+                return;
+            }
+
+            if (streamMode == Mode::bufferData || head == 0)
+            {
+                return; // nothing was written to this segment.
+            }
+
+            if (streamMode == Mode::map)
+            {
+                fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            }
+
+            segment = (segment + 1) % SegmentCount;
+            head = 0;
+            flushed = 0;
+
+            wait(segment);
+        }
+
+        inline size_t StreamBuffer::segmentSize() const
+        {
+            return size;
+        }
+
+        inline StreamBuffer::Mode StreamBuffer::mode() const
+        {
+            return streamMode;
+        }
+
+        inline StreamBuffer::operator GLuint() const
+        {
+            return handle;
+        }
+
+        inline StreamBuffer::Mode StreamBuffer::bestMode()
+        {
+#if defined(TUNIS_LEGACY_BUFFER_UPLOAD)
+            return Mode::bufferData;
+#else
+            bool mapBufferRange = tunisGLSupport(GL_VERSION_3_0) ||
+                                  tunisGLSupport(GL_ES_VERSION_3_0) ||
+                                  tunisGLSupport(GL_ARB_map_buffer_range);
+
+            bool sync = tunisGLSupport(GL_VERSION_3_2) ||
+                        tunisGLSupport(GL_ES_VERSION_3_0) ||
+                        tunisGLSupport(GL_ARB_sync);
+
+            return (mapBufferRange && sync) ? Mode::map : Mode::subData;
+#endif
+        }
+
+        inline void StreamBuffer::bind()
+        {
+            glBindBuffer(target, handle);
+        }
+
+        inline void StreamBuffer::map()
+        {
+            assert(streamMode == Mode::map);
+
+            bind();
+
+            // The fence of this segment was waited on when the ring advanced to
+            // it, and the bytes before 'flushed' are never written again, so
+            // the driver does not need to synchronize anything.
+            mapped = static_cast<uint8_t*>(glMapBufferRange(target,
+                                                            static_cast<GLintptr>(segment * size + flushed),
+                                                            static_cast<GLsizeiptr>(size - flushed),
+                                                            GL_MAP_WRITE_BIT |
+                                                            GL_MAP_UNSYNCHRONIZED_BIT |
+                                                            GL_MAP_INVALIDATE_RANGE_BIT |
+                                                            GL_MAP_FLUSH_EXPLICIT_BIT));
+            assert(mapped != nullptr);
+        }
+
+        inline void StreamBuffer::wait(size_t id)
+        {
+            if (!fences[id])
+            {
+                return;
+            }
+
+            GLenum status;
+            do
+            {
+                status = glClientWaitSync(fences[id], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1ms
+            }
+            while (status == GL_TIMEOUT_EXPIRED);
+
+            glDeleteSync(fences[id]);
+            fences[id] = nullptr;
+        }
+    }
+}
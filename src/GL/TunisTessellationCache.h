@@ -0,0 +1,140 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISTESSELLATIONCACHE_H
+#define TUNISTESSELLATIONCACHE_H
+
+#include <TunisSOA.h>
+#include <TunisVertex.h>
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace tunis
+{
+    namespace detail
+    {
+        struct SubMeshArray : public SoA<uint32_t, uint32_t, uint32_t, uint32_t>
+        {
+            inline uint32_t &vertexStart(size_t idx) { return get<0>(idx); }
+            inline uint32_t &vertexCount(size_t idx) { return get<1>(idx); }
+            inline uint32_t &indexStart(size_t idx) { return get<2>(idx); }
+            inline uint32_t &indexCount(size_t idx) { return get<3>(idx); }
+
+            inline const uint32_t &vertexStart(size_t idx) const { return get<0>(idx); }
+            inline const uint32_t &vertexCount(size_t idx) const { return get<1>(idx); }
+            inline const uint32_t &indexStart(size_t idx) const { return get<2>(idx); }
+            inline const uint32_t &indexCount(size_t idx) const { return get<3>(idx); }
+        };
+
+        /*!
+         * \brief Mesh is the triangulated output of a path, in path space.
+         * There is one sub mesh per sub-path. Indices are relative to the first
+         * vertex of their sub mesh, and are already in the winding order
+         * expected by the renderer.
+         */
+        struct Mesh
+        {
+            std::vector<glm::vec2> vertices;
+            std::vector<Index> indices;
+            SubMeshArray subMeshes;
+            glm::vec2 boundTopLeft;
+            glm::vec2 boundBottomRight;
+
+            void clear();
+            size_t memoryUsage() const;
+        };
+
+        /*!
+         * \brief TessellationCache retains the meshes of the paths drawn in the
+         * previous frames, keyed by a hash of everything their tessellation
+         * depends on. The least recently used meshes are evicted once the
+         * cache grows past its memory budget.
+         *
+         * Meshes stay valid until the next call to collect().
+         */
+        class TessellationCache
+        {
+        public:
+
+            explicit TessellationCache(size_t budget);
+
+            TessellationCache(const TessellationCache &) = delete;
+            TessellationCache &operator=(const TessellationCache &) = delete;
+
+            /*!
+             * \brief find returns the mesh cached under key and marks it as
+             * the most recently used one, or nullptr if there is none or if it
+             * was cached for another check, i.e. on a collision.
+             */
+            Mesh *find(uint64_t key, uint64_t check);
+
+            /*!
+             * \brief insert adds an empty mesh under key, to be filled by the
+             * caller before the next call to collect(). If another mesh is
+             * already cached under key, the new one is not cached, and is only
+             * valid until the next call to collect().
+             */
+            Mesh *insert(uint64_t key, uint64_t check);
+
+            /*!
+             * \brief collect accounts for the meshes inserted since the last
+             * call and evicts the least recently used ones until the cache fits
+             * in its budget.
+             */
+            void collect();
+
+            size_t memoryUsage() const;
+
+            size_t budget;
+
+        private:
+
+            struct Entry
+            {
+                Mesh mesh;
+                uint64_t check = 0;
+                size_t memoryUsage = 0;
+                std::list<uint64_t>::iterator lru;
+            };
+
+            std::unordered_map<uint64_t, Entry> entries;
+            std::list<uint64_t> lru; // most recently used first.
+            std::vector<Entry*> inserted;
+            std::deque<Mesh> uncached; // the meshes of this frame's collisions.
+            std::vector<Mesh> spares; // evicted meshes, recycled with their capacity.
+            size_t usage = 0;
+        };
+    }
+}
+
+#include "TunisTessellationCache.inl"
+
+#endif // TUNISTESSELLATIONCACHE_H
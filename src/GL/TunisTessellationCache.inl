@@ -0,0 +1,144 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisTessellationCache.h>
+
+namespace tunis
+{
+    namespace detail
+    {
+        // keep evicted meshes around so their storage can be reused: at least
+        // a few, and as many as a frame's misses, so a frame re-tessellating
+        // the same draws as the previous one does not allocate meshes.
+        static const size_t MinSpareMeshCount = 64;
+
+        inline void Mesh::clear()
+        {
+            vertices.resize(0);
+            indices.resize(0);
+            subMeshes.resize(0);
+        }
+
+        inline size_t Mesh::memoryUsage() const
+        {
+            return sizeof(Mesh) +
+                   vertices.capacity() * sizeof(glm::vec2) +
+                   indices.capacity() * sizeof(Index) +
+                   subMeshes.size() * sizeof(uint32_t) * 4;
+        }
+
+        inline TessellationCache::TessellationCache(size_t budget) :
+            budget(budget)
+        {
+        }
+
+        inline Mesh *TessellationCache::find(uint64_t key, uint64_t check)
+        {
+            auto it = entries.find(key);
+            if (it == entries.end() || it->second.check != check)
+            {
+                return nullptr;
+            }
+
+            Entry &entry = it->second;
+            lru.splice(lru.begin(), lru, entry.lru);
+            return &entry.mesh;
+        }
+
+        inline Mesh *TessellationCache::insert(uint64_t key, uint64_t check)
+        {
+            if (entries.count(key) > 0)
+            {
+                // the cached mesh may be drawn in this frame too, so leave it
+                // be and tessellate the other path without caching it.
+                uncached.emplace_back();
+                if (spares.size() > 0)
+                {
+                    uncached.back() = std::move(spares.back());
+                    spares.pop_back();
+                }
+
+                uncached.back().clear();
+                return &uncached.back();
+            }
+
+            Entry &entry = entries[key];
+            entry.check = check;
+
+            if (spares.size() > 0)
+            {
+                entry.mesh = std::move(spares.back());
+                spares.pop_back();
+            }
+
+            entry.mesh.clear();
+
+            lru.push_front(key);
+            entry.lru = lru.begin();
+
+            inserted.push_back(&entry);
+
+            return &entry.mesh;
+        }
+
+        inline void TessellationCache::collect()
+        {
+            size_t maxSpareCount = std::max(MinSpareMeshCount, inserted.size() + uncached.size());
+
+            for (size_t i = 0; i < inserted.size(); ++i)
+            {
+                inserted[i]->memoryUsage = inserted[i]->mesh.memoryUsage();
+                usage += inserted[i]->memoryUsage;
+            }
+            inserted.resize(0);
+
+            while (uncached.size() > 0)
+            {
+                if (spares.size() < maxSpareCount)
+                {
+                    spares.emplace_back(std::move(uncached.back()));
+                }
+                uncached.pop_back();
+            }
+
+            while (usage > budget && lru.size() > 0)
+            {
+                auto it = entries.find(lru.back());
+                usage -= it->second.memoryUsage;
+
+                if (spares.size() < maxSpareCount)
+                {
+                    spares.emplace_back(std::move(it->second.mesh));
+                }
+
+                entries.erase(it);
+                lru.pop_back();
+            }
+        }
+
+        inline size_t TessellationCache::memoryUsage() const
+        {
+            return usage;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef TUNISTEXTLAYOUTCACHE_H
+#define TUNISTEXTLAYOUTCACHE_H
+
+#include <TunisFonts_generated.h>
+#include <TunisSOA.h>
+#include <TunisTextMetrics.h>
+
+#include <glm/vec2.hpp>
+
+#include <cinttypes>
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+
+namespace tunis
+{
+    namespace detail
+    {
+        /*!
+         * \brief GlyphQuadArray holds laid out glyphs: the quad covering the
+         * bitmap of each glyph, in user space.
+         */
+        struct GlyphQuadArray : public SoA<const Glyph*, glm::vec2, glm::vec2, float>
+        {
+            inline const Glyph* &glyph(size_t i) { return get<0>(i); }
+            inline glm::vec2 &topLeft(size_t i) { return get<1>(i); }
+            inline glm::vec2 &bottomRight(size_t i) { return get<2>(i); }
+            inline float &range(size_t i) { return get<3>(i); } // distance range of its bitmap, in user space.
+
+            inline const Glyph* const &glyph(size_t i) const { return get<0>(i); }
+            inline const glm::vec2 &topLeft(size_t i) const { return get<1>(i); }
+            inline const glm::vec2 &bottomRight(size_t i) const { return get<2>(i); }
+            inline const float &range(size_t i) const { return get<3>(i); }
+        };
+
+        /*!
+         * \brief TextRun is a string laid out with a font, alignment and
+         * baseline: its glyphs are positioned relative to the point the text
+         * is drawn at, kerning and alignment applied.
+         */
+        struct TextRun
+        {
+            GlyphQuadArray quads;
+            TextMetrics metrics;
+        };
+
+        /*!
+         * \brief TextLayoutCache retains the runs of the strings drawn or
+         * measured recently, keyed by a Hash of the string and of everything
+         * its layout depends on, so labels drawn every frame are only laid
+         * out once. The least recently used runs are evicted past capacity.
+         */
+        class TextLayoutCache
+        {
+        public:
+
+            explicit TextLayoutCache(size_t capacity);
+
+            TextLayoutCache(const TextLayoutCache &) = delete;
+            TextLayoutCache &operator=(const TextLayoutCache &) = delete;
+
+            /*!
+             * \brief find returns the run cached under key and marks it as the
+             * most recently used one, or nullptr if there is none or if it was
+             * cached for another check, i.e. on a collision.
+             */
+            const TextRun *find(uint64_t key, uint64_t check);
+
+            /*!
+             * \brief insert adds an empty run under key, to be filled by the
+             * caller right away, replacing the run of a collision or evicting
+             * the least recently used run if the cache is full. The run stays
+             * valid until the next call.
+             */
+            TextRun *insert(uint64_t key, uint64_t check);
+
+            void clear();
+
+            size_t size() const;
+
+            size_t capacity;
+
+        private:
+
+            struct Entry
+            {
+                TextRun run;
+                uint64_t check = 0;
+                std::list<uint64_t>::iterator lru;
+            };
+
+            std::unordered_map<uint64_t, Entry> entries;
+            std::list<uint64_t> lru; // most recently used first.
+        };
+    }
+}
+
+#include "TunisTextLayoutCache.inl"
+
+#endif // TUNISTEXTLAYOUTCACHE_H
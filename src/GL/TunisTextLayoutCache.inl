@@ -0,0 +1,88 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#include <TunisTextLayoutCache.h>
+
+namespace tunis
+{
+    namespace detail
+    {
+        inline TextLayoutCache::TextLayoutCache(size_t capacity) :
+            capacity(capacity)
+        {
+        }
+
+        inline const TextRun *TextLayoutCache::find(uint64_t key, uint64_t check)
+        {
+            auto it = entries.find(key);
+            if (it == entries.end() || it->second.check != check)
+            {
+                return nullptr;
+            }
+
+            Entry &entry = it->second;
+            lru.splice(lru.begin(), lru, entry.lru);
+            return &entry.run;
+        }
+
+        inline TextRun *TextLayoutCache::insert(uint64_t key, uint64_t check)
+        {
+            auto it = entries.find(key);
+            if (it == entries.end())
+            {
+                while (lru.size() > 0 && lru.size() >= capacity)
+                {
+                    entries.erase(lru.back());
+                    lru.pop_back();
+                }
+
+                lru.push_front(key);
+                it = entries.emplace(key, Entry()).first;
+                it->second.lru = lru.begin();
+            }
+            else
+            {
+                // a collision, runs are only valid until the next call anyway.
+                lru.splice(lru.begin(), lru, it->second.lru);
+            }
+
+            Entry &entry = it->second;
+            entry.check = check;
+            entry.run.quads.resize(0);
+            entry.run.metrics = TextMetrics();
+
+            return &entry.run;
+        }
+
+        inline void TextLayoutCache::clear()
+        {
+            entries.clear();
+            lru.clear();
+        }
+
+        inline size_t TextLayoutCache::size() const
+        {
+            return entries.size();
+        }
+    }
+}
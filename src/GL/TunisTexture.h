@@ -27,6 +27,7 @@
 #include <cinttypes>
 #include <cstddef>
 
+#include <TunisAtlasAllocator.h>
 #include <TunisGL.h>
 #include <TunisImage.h>
 
@@ -45,8 +46,51 @@ namespace tunis
             Texture(int width, int height, Filtering filtering = Filtering::bilinear);
             ~Texture();
 
+            /*!
+             * \brief tryAddImage gives image room in this texture. Its pixels
+             * are not uploaded until upload() is called.
+             */
             bool tryAddImage(Image &img);
 
+            /*!
+             * \brief upload copies the padded pixels of image, already added
+             * to this texture, into its room. pixels is an offset in the bound
+             * GL_PIXEL_UNPACK_BUFFER, if any.
+             */
+            void upload(const Image &image, const void *pixels);
+
+            /*!
+             * \brief removeImage frees the room of image, if it was added to
+             * this texture.
+             */
+            void removeImage(Image &image);
+
+            /*!
+             * \brief collect frees the room of the images no longer referenced
+             * outside of this texture.
+             */
+            void collect();
+
+            /*!
+             * \brief fragmentation returns AtlasAllocator::fragmentation().
+             */
+            float fragmentation() const;
+
+            /*!
+             * \brief occupancy returns the share of the texture taken by
+             * images, from 0 to 1.
+             */
+            float occupancy() const;
+
+            /*!
+             * \brief memoryUsage returns the size of the texture in video
+             * memory, mipmaps included, in bytes.
+             */
+            size_t memoryUsage() const;
+
+            size_t imageCount() const;
+            const Image &image(size_t i) const;
+
             void bind();
             void updateMipmap();
             operator GLuint() const;
@@ -57,7 +101,10 @@ namespace tunis
             int32_t width, height;
             Filtering filtering;
             bool mipmapDirty;
+            AtlasAllocator allocator;
             std::vector<Image> images;
+
+            void release(size_t i);
         };
     }
 
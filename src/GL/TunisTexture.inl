@@ -30,6 +30,8 @@
 #include <soa.h>
 #include <glm/vec4.hpp>
 
+#include <cassert>
+
 namespace tunis
 {
     namespace detail
@@ -38,7 +40,8 @@ namespace tunis
             width(width),
             height(height),
             filtering(filtering),
-            mipmapDirty(false)
+            mipmapDirty(false),
+            allocator(width, height)
         {
             glGenTextures(1, &handle);
             glBindTexture(GL_TEXTURE_2D, handle);
@@ -50,6 +53,10 @@ namespace tunis
             // corner that we're going to be using to render solid color without having
             // to switch shaders, allowing the batch to continue without interruptions.
 
+            int32_t whiteX, whiteY;
+            allocator.allocate(gfxStates.texPadding, gfxStates.texPadding, whiteX, whiteY);
+            assert(whiteX == 0 && whiteY == 0);
+
             std::vector<uint8_t> whiteSubTexture(gfxStates.texPadding*gfxStates.texPadding*4, 0xFF);
             glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, gfxStates.texPadding, gfxStates.texPadding, GL_RGBA, GL_UNSIGNED_BYTE, whiteSubTexture.data());
 
@@ -130,50 +137,28 @@ namespace tunis
                 return true;
             }
 
-            int32_t maxWidth = gfxStates.maxTexSize - paddedBounds.width();
-            int32_t maxHeight = gfxStates.maxTexSize - paddedBounds.height();
-            paddedBounds.setY(0);
-
-            if (images.size() == 0)
+            int32_t x, y;
+            if (!allocator.allocate(paddedBounds.width(), paddedBounds.height(), x, y))
             {
-                goto SpotFound;
-            }
-
-            while(paddedBounds.y() < maxHeight)
-            {
-                paddedBounds.setX(0);
-                while(paddedBounds.x() < maxWidth)
-                {
-                    bool bOccupied = false;
-                    for (size_t i = 0; i < images.size(); ++i)
-                    {
-                        Image &subImage = images[i];
-                        auto &subTexturePaddingBound = subImage.paddedBounds();
-                        if (paddedBounds.intersects(subTexturePaddingBound))
-                        {
-                            bOccupied = true;
-                            paddedBounds.setX(subTexturePaddingBound.right());
-                        }
-
-                        if (!bOccupied)
-                        {
-                            goto SpotFound;
-                        }
-                    }
-                }
-                paddedBounds.setY(paddedBounds.y()+1);
+                // no room to add image to this texture.
+                return false;
             }
 
-            // no room to add image to this texture.
-            return false;
-
-SpotFound:
-
+            paddedBounds.setX(x);
+            paddedBounds.setY(y);
             bounds.setX(paddedBounds.x() + gfxStates.texPadding);
             bounds.setY(paddedBounds.y() + gfxStates.texPadding);
 
+            image.parent() = this;
             images.push_back(image);
 
+            return true;
+        }
+
+        void Texture::upload(const Image &image, const void *pixels)
+        {
+            const auto &paddedBounds = image.paddedBounds();
+
             Texture::bind();
             glTexSubImage2D(GL_TEXTURE_2D, 0,
                             paddedBounds.x(),
@@ -181,11 +166,82 @@ SpotFound:
                             paddedBounds.width(),
                             paddedBounds.height(),
                             GL_RGBA, GL_UNSIGNED_BYTE,
-                            image.data().data());
+                            pixels);
 
             mipmapDirty = filtering == Filtering::bilinearMipmap || filtering == Filtering::trilinear;
+        }
 
-            return true;
+        void Texture::removeImage(Image &image)
+        {
+            for (size_t i = 0; i < images.size(); ++i)
+            {
+                if (images[i] == image)
+                {
+                    release(i);
+                    return;
+                }
+            }
+        }
+
+        void Texture::collect()
+        {
+            for (size_t i = 0; i < images.size();)
+            {
+                // only this texture still holds it.
+                if (images[i].getRefCount() == 1)
+                {
+                    release(i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+
+        float Texture::fragmentation() const
+        {
+            return allocator.fragmentation();
+        }
+
+        float Texture::occupancy() const
+        {
+            return static_cast<float>(allocator.usedArea()) / (static_cast<float>(width) * height);
+        }
+
+        size_t Texture::memoryUsage() const
+        {
+            size_t size = static_cast<size_t>(width) * height * 4;
+
+            // a full mipmap chain adds a third.
+            if (filtering == Filtering::bilinearMipmap || filtering == Filtering::trilinear)
+            {
+                size += size / 3;
+            }
+
+            return size;
+        }
+
+        size_t Texture::imageCount() const
+        {
+            return images.size();
+        }
+
+        const Image &Texture::image(size_t i) const
+        {
+            return images[i];
+        }
+
+        void Texture::release(size_t i)
+        {
+            Image &image = images[i];
+            const auto &paddedBounds = image.paddedBounds();
+            allocator.deallocate(paddedBounds.x(), paddedBounds.y(), paddedBounds.width());
+            image.parent() = nullptr;
+            image.loading() = false; // its upload, if any, is dropped.
+
+            images[i] = images.back();
+            images.pop_back();
         }
 
         void Texture::bind()
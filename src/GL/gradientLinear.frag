@@ -28,26 +28,69 @@ precision highp float;
 #endif
 
 uniform vec2 u_viewSize;
-uniform vec4 u_uniforms[7];
+uniform sampler2D u_gradients;
+uniform vec2 u_gradientsSize;
+uniform sampler2D u_ramps;
+uniform vec2 u_rampsSize;
 
-#define u_start            u_uniforms[0].xy
-#define u_dt              u_uniforms[0].zw
-#define u_lenSq            u_uniforms[1].x
-#define u_colorStopCount   int(u_uniforms[1].w)
-#define u_colorStop(INDEX) u_uniforms[2][INDEX]
-#define u_color(INDEX)     u_uniforms[3+(INDEX)]
+varying float v_gradient;
+varying vec2 v_paintPosition; // in user space, like the gradient parameters.
 
-void main()
+#if defined(TUNIS_PACKED_GRADIENTS)
+// float whose bits are stored in bytes, most significant first. Denormals are
+// flushed to zero.
+float unpack(vec4 bytes)
 {
-    float t = dot(gl_FragCoord.xy - u_start, u_dt)/ u_lenSq;
-
-    vec4 color = mix(u_color(0), u_color(1), clamp((t - u_colorStop(0))/(u_colorStop(1) - u_colorStop(0)), 0.0, 1.0));
-    for (int i = 2; i < u_colorStopCount; ++i)
+    bytes = floor(bytes * 255.0 + 0.5);
+    float exponent = mod(bytes.x, 128.0) * 2.0 + floor(bytes.y / 128.0);
+    if (exponent == 0.0)
     {
-        color = mix(color, u_color(i), clamp((t - u_colorStop(i-1))/(u_colorStop(i) - u_colorStop(i-1)), 0.0, 1.0));
+        return 0.0;
     }
+    float mantissa = 1.0 + (mod(bytes.y, 128.0) * 65536.0 + bytes.z * 256.0 + bytes.w) / 8388608.0;
+    float value = mantissa * exp2(exponent - 127.0);
+    return bytes.x >= 128.0 ? -value : value;
+}
+#endif
+
+// texel of the gradient starting at v_gradient: two texels of parameters, the
+// last one ending with the row of its color ramp.
+vec4 gradient(float index)
+{
+    float texel = floor(v_gradient + 0.5) + index;
+    float row = floor(texel / u_gradientsSize.x);
+#if defined(TUNIS_PACKED_GRADIENTS)
+    // four RGBA8 texels per vec4, one per component.
+    vec2 size = vec2(u_gradientsSize.x * 4.0, u_gradientsSize.y);
+    vec2 uv = vec2((texel - row * u_gradientsSize.x) * 4.0, row) + 0.5;
+    return vec4(unpack(texture2D(u_gradients, uv / size)),
+                unpack(texture2D(u_gradients, (uv + vec2(1.0, 0.0)) / size)),
+                unpack(texture2D(u_gradients, (uv + vec2(2.0, 0.0)) / size)),
+                unpack(texture2D(u_gradients, (uv + vec2(3.0, 0.0)) / size)));
+#else
+    return texture2D(u_gradients, (vec2(texel - row * u_gradientsSize.x, row) + 0.5) / u_gradientsSize);
+#endif
+}
+
+// color at t of the ramp baked in row.
+vec4 ramp(float row, float t)
+{
+    return texture2D(u_ramps, vec2((clamp(t, 0.0, 1.0) * (u_rampsSize.x - 1.0) + 0.5) / u_rampsSize.x, (row + 0.5) / u_rampsSize.y));
+}
+
+void main()
+{
+    vec4 params0 = gradient(0.0);
+    vec4 params1 = gradient(1.0);
+
+    vec2 start = params0.xy;
+    vec2 dt = params0.zw;
+    float lenSq = params1.x;
+    float row = params1.w;
+
+    float t = dot(v_paintPosition - start, dt)/ lenSq;
 
-    gl_FragColor = color;
+    gl_FragColor = ramp(row, t);
 };
 
 )"
@@ -30,9 +30,16 @@ precision highp float;
 uniform vec2 u_viewSize;
 
 attribute vec2 a_position;
+attribute float a_gradient;
+attribute vec2 a_paintPosition;
+
+varying float v_gradient;
+varying vec2 v_paintPosition;
 
 void main()
 {
+    v_gradient = a_gradient;
+    v_paintPosition = a_paintPosition;
     gl_Position  = vec4(2.0*a_position.x/u_viewSize.x - 1.0, 1.0 - 2.0*a_position.y/u_viewSize.y, 0, 1);
 };
 
@@ -0,0 +1,54 @@
+R"(
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+#if defined(GL_ES)
+precision highp float;
+#endif
+
+uniform vec2 u_viewSize;
+
+attribute vec2 a_position;
+
+// per instance: the rows (a c e) and (b d f) of the transform, and the color.
+attribute vec3 a_transform0;
+attribute vec3 a_transform1;
+attribute vec4 a_color;
+
+varying vec4 v_color;
+
+void main()
+{
+    vec3 position = vec3(a_position, 1.0);
+    vec2 transformed = vec2(dot(a_transform0, position), dot(a_transform1, position));
+
+    v_color      = a_color;
+    gl_Position  = vec4(2.0 * transformed.x / u_viewSize.x - 1.0,
+                        1.0 - 2.0 * transformed.y / u_viewSize.y,
+                        0,
+                        1);
+};
+
+)"
@@ -0,0 +1,61 @@
+R"(
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Matt Chiasson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+#if defined(GL_ES)
+precision highp float;
+#endif
+
+varying vec2 v_texcoord;
+varying vec4 v_color;
+varying float v_range;  // pixels covered by the distance range.
+varying float v_stroke; // half the line width in pixels, 0 to fill.
+
+uniform sampler2D u_texture0;
+
+float median(vec3 v)
+{
+    return max(min(v.r, v.g), min(max(v.r, v.g), v.b));
+}
+
+void main()
+{
+    // signed distance to the edge of the glyph, in pixels, positive inside.
+    float distance = v_range * (median(texture2D(u_texture0, v_texcoord).rgb) - 0.5);
+
+    float coverage;
+    if (v_stroke > 0.0)
+    {
+        coverage = clamp(v_stroke - abs(distance) + 0.5, 0.0, 1.0);
+    }
+    else
+    {
+        coverage = clamp(distance + 0.5, 0.0, 1.0);
+    }
+
+    gl_FragColor = vec4(v_color.rgb, v_color.a * coverage);
+};
+
+)"
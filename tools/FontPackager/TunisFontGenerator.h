@@ -15,6 +15,9 @@ class FontGenerator
 public:
 
     void generate(const std::string output, const std::vector<FT_Face> &faces);
+
+    // also write the bitmap of every glyph to <family>/<weight>/<unicode>.png.
+    bool dumpGlyphs = false;
 };
 
 }
@@ -74,6 +74,11 @@ namespace tunis
                         .repeatable(true)
                         .argument("family")
                         .callback(Poco::Util::OptionCallback<FontPackager>(this, &FontPackager::handleWebFont)));
+
+            options.addOption(Poco::Util::Option("dump-glyphs", "d", "Also write the bitmap of every glyph as <family>/<weight>/<unicode>.png, for debugging.")
+                        .required(false)
+                        .repeatable(false)
+                        .callback(Poco::Util::OptionCallback<FontPackager>(this, &FontPackager::handleDumpGlyphs)));
         }
 
         void displayHelp()
@@ -81,7 +86,7 @@ namespace tunis
             Poco::Util::HelpFormatter helpFormatter(options());
             helpFormatter.setCommand(commandName());
             helpFormatter.setHeader("Tunis Font Packager.\nCopyright (c) 2015-2018 Mathieu-Andre Chiasson\nAll rights reserved.\n\nTurns group of font into a Tunis font Package (.tfp)");
-            helpFormatter.setUsage("[-f <pattern1> [-f <pattern2> [...]]] [-w family1 [-w family2 [...]]]");
+            helpFormatter.setUsage("[-d] [-f <pattern1> [-f <pattern2> [...]]] [-w family1 [-w family2 [...]]]");
             helpFormatter.format(std::cout);
         }
 
@@ -106,6 +111,11 @@ namespace tunis
             m_loader.addFamily(value);
         }
 
+        void handleDumpGlyphs(const std::string& name, const std::string& value)
+        {
+            m_generator.dumpGlyphs = true;
+        }
+
         int main(const std::vector<std::string>& args)
         {
             if (m_helpRequested)